@@ -34,15 +34,66 @@ bool SortVertices(vertex* v1, vertex* v2)
 	return v1->lon < v2->lon;
 }
 
+// TMG 2.0 traveled graphs encode each edge's travelers as a hex string, one character per 4 travelers,
+// lowest-numbered traveler in the low-order bit. TMG 3.0 lists runs of consecutive traveler numbers,
+// separated by '.', each as the gap since the end of the previous run, then '+' & any additional length.
+// An edge with no travelers is "0" in TMG 2.0 (or all 0s), or "-" in TMG 3.0.
+
+void decode_travelers(const char* code, bool tmg3, vector<size_t>& travelers)
+{	if (tmg3)
+	{	if (*code == '-') return;
+		size_t next = 0;
+		while (*code)
+		{	char* c;
+			size_t beg = next + strtoul(code, &c, 10);
+			size_t last = beg;
+			if (*c == '+') last += strtoul(c+1, &c, 10);
+			for (size_t t = beg; t <= last; t++) travelers.push_back(t);
+			next = last+1;
+			code = *c == '.' ? c+1 : c;
+		}
+		return;
+	}
+	for (size_t i = 0; code[i]; i++)
+	{	unsigned int nibble = code[i] <= '9' ? code[i]-'0' : (code[i] & ~32)-'A'+10;
+		for (size_t b = 0; b < 4; b++)
+			if (nibble & 1 << b) travelers.push_back(4*i+b);
+	}
+}
+
+string encode_travelers(vector<size_t>& travelers, bool tmg3, size_t NumTrav)
+{	string code;
+	if (tmg3)
+	{	if (travelers.empty()) return "-";
+		size_t next = 0;
+		for (size_t i = 0; i < travelers.size();)
+		{	size_t beg = travelers[i];
+			while (i+1 < travelers.size() && travelers[i+1] == travelers[i]+1) i++;
+			size_t last = travelers[i++];
+			if (next) code += '.';
+			code += to_string(beg-next);
+			if (last > beg) code += '+' + to_string(last-beg);
+			next = last+1;
+		}
+		return code;
+	}
+	if (!NumTrav) return "0";
+	code.assign((NumTrav+3)/4, 0);
+	for (size_t t : travelers) code[t/4] |= 1 << t%4;
+	for (char& c : code) c = "0123456789ABCDEF"[(unsigned char)c];
+	return code;
+}
+
 class edge
 {	public:
 	size_t BegI, EndI;
 	//size_t qty;
 	vertex* BegP,* EndP;
-	string label, clinchedby_code;
+	string label;
+	vector<size_t> travelers;
 	vector<double> iLat, iLon;
 
-	edge(string &ConstLine, vector<vertex*> &v_vector, bool traveled)
+	edge(string &ConstLine, vector<vertex*> &v_vector, bool traveled, bool tmg3)
 	{	char* c;
 		char* l = new char[ConstLine.size()+2];
 		strcpy(l, ConstLine.data());
@@ -53,8 +104,9 @@ class edge
 			// strtok(0, FOO) is not threadsafe. Don't use.
 
 		if (traveled)
-		{	clinchedby_code = strtok(c+1, " ");
-			c += clinchedby_code.size() + 1;
+		{	char* code = strtok(c+1, " ");
+			c += strlen(code) + 1;
+			decode_travelers(code, tmg3, travelers);
 		}
 
 		while (*(c+1))
@@ -93,11 +145,11 @@ void reverse(vector<double>& v)
 
 class tmg
 {	public:
-	string pathname, destination, tag, version, format;
+	string pathname, destination, tag, version, format, out_version;
 	size_t NumVertices, NumEdges, NumTrav;
 	bool opened, traveled;
 
-	tmg(string&& entry, std::string&& dest)
+	tmg(string&& entry, std::string&& dest, const char* trav_version)
 	{	pathname = entry;
 		destination = dest;
 		opened = 1;
@@ -111,6 +163,7 @@ class tmg
 		}
 		file >> tag >> version >> format;
 		traveled = format == "traveled";
+		out_version = traveled && trav_version ? trav_version : version;
 		// enforce newline between header lines
 		string line;
 		getline(file, line);
@@ -127,7 +180,7 @@ class tmg
 		bool valid = 1;
 		if (tag != "TMG") valid = 0;
 		else	if (version != "1.0")
-		{	if (version != "2.0" || !traveled) valid = 0;
+		{	if ((version != "2.0" && version != "3.0") || !traveled) valid = 0;
 		}
 		else	if (format != "collapsed" && format != "simple") valid = 0;
 		if (!valid)
@@ -180,7 +233,7 @@ void tmg::canonicaltmg()
 	// read edges
 	for (size_t i = 0; i < NumEdges; i++)
 	{	getline(input, tmgline);
-		e_list.push_back(new edge(tmgline, v_vector, traveled));
+		e_list.push_back(new edge(tmgline, v_vector, traveled, version == "3.0"));
 		/*cout << edges.back()->BegI << ' ' << edges.back()->EndI << ' ' << edges.back()->label;
 		  for (double s : edges.back()->shape) cout << ' ' << s;
 		  cout << '\n';//*/
@@ -223,7 +276,7 @@ void tmg::canonicaltmg()
 
 	// write output TMG
 	ofstream output(destination);
-	output << tag << ' ' << version << ' ' << format << '\n';
+	output << tag << ' ' << out_version << ' ' << format << '\n';
 	output << NumVertices << ' ' << NumEdges;
 	if (traveled) output << ' ' << NumTrav;
 	output << '\n';
@@ -233,7 +286,7 @@ void tmg::canonicaltmg()
 	{	output << e->BegP->vertex_num << ' ';
 		output << e->EndP->vertex_num << ' ';
 		output << e->label;
-		if (traveled) output << ' ' << e->clinchedby_code;
+		if (traveled) output << ' ' << encode_travelers(e->travelers, out_version == "3.0", NumTrav);
 		// intermediate points
 		for (size_t i = 0; i < e->iLat.size(); i++)
 		{	output << ' ' << to_string(e->iLat[i]);
@@ -277,18 +330,21 @@ int main(int argc, char* argv[])
 	string msg;
 	mutex mtx;
 
-	switch (argc)
-	{	case 3 : src = argv[1];
-			 dest = argv[2];
-			 break;
-		case 5 : if (!strcmp(argv[1], "-t"))
-			 {	T = strtoul(argv[2], 0, 10);
-				src = argv[3];
-				dest = argv[4];
-				break;
-			 }
-		default: cout << "usage: " << argv[0] <<" [-t NumThreads] <InputPath> <OutputPath>\n"; return 1;
+	const char* trav_version = 0;
+	int a = 1;
+	for (; a+2 < argc; a += 2)
+	{	if (!strcmp(argv[a], "-t"))
+			T = strtoul(argv[a+1], 0, 10);
+		else if (!strcmp(argv[a], "-v") && (!strcmp(argv[a+1], "2.0") || !strcmp(argv[a+1], "3.0")))
+			trav_version = argv[a+1];
+		else break;
+	}
+	if (a+2 != argc)
+	{	cout << "usage: " << argv[0] <<" [-t NumThreads] [-v TraveledVersion] <InputPath> <OutputPath>\n";
+		return 1;
 	}
+	src = argv[a];
+	dest = argv[a+1];
 	if (!T) T = thread::hardware_concurrency();
 	if (!T) T = 1;
 	vector<thread> thr(T);
@@ -299,7 +355,7 @@ int main(int argc, char* argv[])
 	     {	while ((ent = readdir(dir)) != NULL)
 		{	string entry = string(src) + "/" + ent->d_name;
 			if (entry.substr(entry.size()-4) == ".tmg")
-			{	graphlist.emplace_back( move(entry), dest + entry.substr(entry.find_last_of('/')) );
+			{	graphlist.emplace_back( move(entry), dest + entry.substr(entry.find_last_of('/')), trav_version );
 				if (!graphlist.back().valid_header())
 				{	cout << "Skipping " << graphlist.back().pathname << endl;
 					graphlist.pop_back();
@@ -308,7 +364,7 @@ int main(int argc, char* argv[])
 		}
 		closedir(dir);
 	     }
-	else {	graphlist.emplace_back(src, dest);
+	else {	graphlist.emplace_back(src, dest, trav_version);
 		if (!graphlist.back().valid_header())
 		{	cout << "Skipping " << graphlist.back().pathname << endl;
 			graphlist.pop_back();
@@ -4,11 +4,17 @@
 /* t */ int Args::numthreads = 4;
 /* T */ int Args::timeprecision = 1;
 /* e */ bool Args::errorcheck = 0;
+/* q */ bool Args::quickcheck = 0;
+/* q */ std::list<std::string> Args::scope;
 /* k */ bool Args::skipgraphs = 0;
 /* v */ bool Args::mtvertices = 0;
 /* C */ bool Args::stcsvfiles = 0;
 /* E */ bool Args::edgecounts = 0;
 /* b */ bool Args::bitsetlogs = 0;
+/* 3 */ bool Args::tmg3 = 0;
+/* f */ bool Args::forcegraphs = 0;
+/* B */ bool Args::bulkload = 0;
+/* D */ bool Args::deltasql = 0;
 /* w */ std::string Args::datapath = "../../HighwayData";
 /* s */ std::string Args::systemsfile = "systems.csv";
 /* u */ std::string Args::userlistfilepath = "../../UserData/list_files";
@@ -38,6 +44,10 @@ bool Args::init(int argc, char *argv[])
 		else if ARG(0, "-C", "--st-csvs")		 stcsvfiles = 1;
 		else if ARG(0, "-E", "--edge-counts")		 edgecounts = 1;
 		else if ARG(0, "-b", "--bitset-logs")		 bitsetlogs = 1;
+		else if ARG(0, "-3", "--tmg3")			 tmg3 = 1;
+		else if ARG(0, "-f", "--force-graphs")		 forcegraphs = 1;
+		else if ARG(0, "-B", "--bulk-load")		 bulkload = 1;
+		else if ARG(0, "-D", "--delta-sql")		 deltasql = 1;
 		else if ARG(0, "-h", "--help")			{show_help(); return 1;}
 		else if ARG(1, "-w", "--datapath")		{datapath	  = argv[++n];}
 		else if ARG(1, "-s", "--systemsfile")		{systemsfile      = argv[++n];}
@@ -65,6 +75,13 @@ bool Args::init(int argc, char *argv[])
 		{	nmpthreshold = strtod(argv[++n], 0);
 			if (nmpthreshold<0) nmpthreshold=0.0005;  /* default */
 		}
+		else if ARG(0, "-q", "--quick-datacheck")
+		{	errorcheck = quickcheck = 1;
+			while (n+1 < argc && argv[n+1][0] != '-')
+			{	scope.push_back(argv[n+1]);
+				n++;
+			}
+		}
 		else if ARG(1, "-U", "--userlist")
 			while (n+1 < argc && argv[n+1][0] != '-')
 			{	userlist.push_back(argv[n+1]);
@@ -92,7 +109,8 @@ void Args::show_help()
 	std::cout  <<  indent << "        [-c CSVSTATFILEPATH] [-g GRAPHFILEPATH] [-k]\n";
 	std::cout  <<  indent << "        [-n NMPMERGEPATH] [-p SPLITREGIONPATH SPLITREGION]\n";
 	std::cout  <<  indent << "        [-U USERLIST [USERLIST ...]] [-t NUMTHREADS] [-e]\n";
-	std::cout  <<  indent << "        [-T TIMEPRECISION] [-v] [-C] [-E] [-b]\n";
+	std::cout  <<  indent << "        [-q [REGION|SYSTEM ...]]\n";
+	std::cout  <<  indent << "        [-T TIMEPRECISION] [-v] [-C] [-E] [-b] [-3] [-f] [-B] [-D]\n";
 	std::cout  <<  indent << "        [-L COLOCATIONLIMIT] [-N NMPTHRESHOLD]\n";
 	std::cout  <<  "\n";
 	std::cout  <<  "Create SQL, stats, graphs, and log files from highway and user data for the\n";
@@ -132,6 +150,10 @@ void Args::show_help()
 	std::cout  <<  "		        Number of threads to use for concurrent tasks\n";
 	std::cout  <<  "  -e, --errorcheck      Run only the subset of the process needed to verify\n";
 	std::cout  <<  "		        highway data changes\n";
+	std::cout  <<  "  -q [REGION|SYSTEM ...], --quick-datacheck [REGION|SYSTEM ...]\n";
+	std::cout  <<  "		        As -e, skipping traveler lists & stats. If regions\n";
+	std::cout  <<  "		        or systems are given, only their routes and those\n";
+	std::cout  <<  "		        near them are read, and only theirs are checked\n";
 	std::cout  <<  "  -T TIMEPRECISION, --timeprecision TIMEPRECISION\n";
 	std::cout  <<  "		        Number of digits (1-9) after decimal point in\n";
 	std::cout  <<  "		        timestamp readouts\n";
@@ -140,6 +162,15 @@ void Args::show_help()
 	std::cout  <<  "  -E, --edge-counts     Report the quantity of each format graph edge\n";
 	std::cout  <<  "  -b, --bitset-logs     Write TMBitset RAM use logs for region & system\n";
 	std::cout  <<  "		        vertices & edges\n";
+	std::cout  <<  "  -3, --tmg3            Write traveled graphs in TMG 3.0 format, listing\n";
+	std::cout  <<  "		        each edge's travelers as runs of traveler numbers\n";
+	std::cout  <<  "  -f, --force-graphs    Rewrite all graph files, even those whose contents\n";
+	std::cout  <<  "		        are unchanged since the last run\n";
+	std::cout  <<  "  -B, --bulk-load       Write the database as a schema .sql file, one\n";
+	std::cout  <<  "		        tab-separated data file per table, and a .load.sql\n";
+	std::cout  <<  "		        script to LOAD DATA LOCAL INFILE them\n";
+	std::cout  <<  "  -D, --delta-sql       Also write a .delta.sql script of only the rows\n";
+	std::cout  <<  "		        changed since the last run, per its .manifest file\n";
 	std::cout  <<  "  -L, --colocationlimit COLOCATIONLIMIT\n";
 	std::cout  <<  "		        Threshold to report colocation counts\n";
 	std::cout  <<  "  -N, --nmp-threshold NMPTHRESHOLD\n";
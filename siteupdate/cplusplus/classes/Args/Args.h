@@ -17,11 +17,17 @@ class Args
 	/* U */ static std::list<std::string> userlist;
 	/* t */ static int numthreads;
 	/* e */ static bool errorcheck;
+	/* q */ static bool quickcheck;
+	/* q */ static std::list<std::string> scope;
 	/* T */ static int timeprecision;
 	/* v */ static bool mtvertices;
 	/* C */ static bool stcsvfiles;
 	/* E */ static bool edgecounts;
 	/* b */ static bool bitsetlogs;
+	/* 3 */ static bool tmg3;
+	/* f */ static bool forcegraphs;
+	/* B */ static bool bulkload;
+	/* D */ static bool deltasql;
 	/* L */ static int colocationlimit;
 	/* N */ static double nmpthreshold; 
 		static const char* exec;
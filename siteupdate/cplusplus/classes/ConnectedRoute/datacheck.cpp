@@ -9,8 +9,8 @@ void ConnectedRoute::verify_connectivity()
 	auto& q = roots[i-1];
 	auto& r = roots[i];
 	auto flag = [&]()
-	{	Datacheck::add(q, q->con_end()->label, "", "", "DISCONNECTED_ROUTE",  r->points[0].root_at_label());
-		Datacheck::add(r,  r->points[0].label, "", "", "DISCONNECTED_ROUTE", q->con_end()->root_at_label());
+	{	Datacheck::add(q, &q->con_end()->label, 0, 0, Datacheck::DISCONNECTED_ROUTE,  r->points.data);
+		Datacheck::add(r,  &r->points[0].label, 0, 0, Datacheck::DISCONNECTED_ROUTE, q->con_end());
 		disconnected = 1;
 		q->set_disconnected();
 		r->set_disconnected();
@@ -47,5 +47,5 @@ void ConnectedRoute::combine_con_routes()
 		if (w->route->region != p->route->region && system == p->route->system && this < cr2)
 		  if (p == cr2->roots[0]->con_beg() || p == cr2->roots.back()->con_end())
 		    if (w->route->route == p->route->route && w->route->banner == p->route->banner)
-		      Datacheck::add(w->route,  w->label, "", "", "COMBINE_CON_ROUTES", p->root_at_label());
+		      Datacheck::add(w->route,  &w->label, 0, 0, Datacheck::COMBINE_CON_ROUTES, p);
 }
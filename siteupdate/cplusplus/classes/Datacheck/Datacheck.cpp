@@ -1,44 +1,99 @@
+#define FMT_HEADER_ONLY
 #include "Datacheck.h"
 #include "../Args/Args.h"
-#include "../ElapsedTime/ElapsedTime.h"
 #include "../ErrorList/ErrorList.h"
 #include "../Route/Route.h"
+#include "../Waypoint/Waypoint.h"
 #include "../../functions/tmstring.h"
+#include <fmt/format.h>
 #include <fstream>
 
 std::mutex Datacheck::mtx;
-std::list<Datacheck> Datacheck::errors;
+std::vector<Datacheck> Datacheck::errors;
+std::list<Datacheck::Buffer> Datacheck::buffers;
+thread_local Datacheck::Buffer* Datacheck::buffer = 0;
+std::string const Datacheck::none;
 
-void Datacheck::add(Route *rte, std::string l1, std::string l2, std::string l3, std::string c, std::string i)
-{	mtx.lock();
-	errors.emplace_back(rte, l1, l2, l3, c, i);
-	mtx.unlock();
+Datacheck::Buffer& Datacheck::this_thread()
+{	// the lock is only taken once per thread, for its first error
+	if (!buffer)
+	{	mtx.lock();
+		buffers.emplace_back();
+		buffer = &buffers.back();
+		mtx.unlock();
+	}
+	return *buffer;
+}
+
+const std::string* Datacheck::keep(std::string&& str)
+{	std::deque<std::string>& kept = this_thread().kept;
+	kept.emplace_back(std::move(str));
+	return &kept.back();
+}
+
+void Datacheck::add(Route *rte, const std::string* l1, const std::string* l2, const std::string* l3, Code c, std::string&& i)
+{	std::vector<Datacheck>& e = this_thread().errors;
+	e.emplace_back(rte, l1, l2, l3, c);
+	e.back().text = i.empty() ? 0 : keep(std::move(i));
+}
+
+void Datacheck::add(Route *rte, const std::string* l1, const std::string* l2, const std::string* l3, Code c, Waypoint* w)
+{	std::vector<Datacheck>& e = this_thread().errors;
+	e.emplace_back(rte, l1, l2, l3, c);
+	e.back().point = w;
+}
+
+void Datacheck::add(Route *rte, const std::string* l1, const std::string* l2, const std::string* l3, Code c, Route* r)
+{	std::vector<Datacheck>& e = this_thread().errors;
+	e.emplace_back(rte, l1, l2, l3, c);
+	e.back().other = r;
+}
+
+void Datacheck::add(Route *rte, const std::string* l1, const std::string* l2, const std::string* l3, Code c, double v)
+{	std::vector<Datacheck>& e = this_thread().errors;
+	e.emplace_back(rte, l1, l2, l3, c);
+	e.back().value = v;
+}
+
+void Datacheck::add(Route *rte, const std::string* l1, const std::string* l2, const std::string* l3, Code c, size_t n)
+{	std::vector<Datacheck>& e = this_thread().errors;
+	e.emplace_back(rte, l1, l2, l3, c);
+	e.back().count = n;
 }
 
-Datacheck::Datacheck(Route *rte, std::string l1, std::string l2, std::string l3, std::string c, std::string i)
+Datacheck::Datacheck(Route *rte, const std::string* l1, const std::string* l2, const std::string* l3, Code c)
 {	route = rte;
-	label1 = l1;
-	label2 = l2;
-	label3 = l3;
+	label1 = l1 ? l1 : &none;
+	label2 = l2 ? l2 : &none;
+	label3 = l3 ? l3 : &none;
 	code = c;
-	info = i;
 	fp = 0;
 }
 
-bool Datacheck::match_except_info(std::string* fpentry)
-{	// Check if the fpentry from the csv file matches in all fields
-	// except the info field
-	if (fpentry[0] != route->root)	return 0;
-	if (fpentry[1] != label1)	return 0;
-	if (fpentry[2] != label2)	return 0;
-	if (fpentry[3] != label3)	return 0;
-	if (fpentry[4] != code)		return 0;
-	return 1;
+std::string Datacheck::info() const
+{	switch (code)
+	{	case LONG_SEGMENT:
+		case SHARP_ANGLE:
+		case VISIBLE_DISTANCE:		return fmt::format("{:.2f}", value);
+		case COMBINE_CON_ROUTES:
+		case DISCONNECTED_ROUTE:
+		case VISIBLE_HIDDEN_COLOC:	return point->root_at_label();
+		case DUPLICATE_COORDS:
+		case OUT_OF_BOUNDS:		return fmt::format("({:.15},{:.15})", point->lat, point->lng);
+		case HIDDEN_JUNCTION:		return std::to_string(count);
+		case MULTI_REGION_OVERLAP:	return other->root;
+		default:			return text ? *text : none;
+	}
+}
+
+std::string Datacheck::fp_key(std::string const& root, std::string const& l1, std::string const& l2, std::string const& l3, std::string const& code)
+{	// newlines can't be part of any field read from a file line by line
+	return root + '\n' + l1 + '\n' + l2 + '\n' + l3 + '\n' + code;
 }
 
 // Original "Python list" format unused. Using "CSV style" format instead.
 std::string Datacheck::str() const
-{	return route->root + ";" + label1 + ";" + label2 + ";" + label3 + ";" + code + ";" + info;
+{	return route->root + ";" + *label1 + ";" + *label2 + ";" + *label3 + ";" + codes[code] + ";" + info();
 }
 
 void Datacheck::read_fps(ErrorList &el)
@@ -63,57 +118,38 @@ void Datacheck::read_fps(ErrorList &el)
 		if (NumFields != 6)
 		{	el.add_error("Could not parse datacheckfps.csv line: [" + line
 				   + "], expected 6 fields, found " + std::to_string(NumFields));
+			delete[] fields;
 			continue;
 		}
 		if (always_error.count(fields[4]))
-			std::cout << "datacheckfps.csv line not allowed (always error): " << line << std::endl;
-		else	fps.push_back(fields);
+		{	std::cout << "datacheckfps.csv line not allowed (always error): " << line << std::endl;
+			delete[] fields;
+		}
+		else if (Route::out_of_scope(fields[0]))
+			delete[] fields; // can neither match nor go unmatched
+		else {	fp_index[fp_key(fields[0], fields[1], fields[2], fields[3], fields[4])].push_back(fps.size());
+			fps.push_back(fields);
+		     }
 	}
 	file.close();
 }
 
-void Datacheck::mark_fps(ElapsedTime &et)
-{	errors.sort();
-	std::ofstream fpfile(Args::logfilepath+"/nearmatchfps.log");
-	time_t timestamp = time(0);
-	fpfile << "Log file created at: " << ctime(&timestamp);
-	unsigned int counter = 0;
-	unsigned int fpcount = 0;
-	for (Datacheck& d : errors)
-	{	//std::cout << "Checking: " << d->str() << std::endl;
-		counter++;
-		if (counter % 1000 == 0) std::cout << '.' << std::flush;
-		for (std::list<std::string*>::iterator fp = fps.begin(); fp != fps.end(); fp++)
-		  if (d.match_except_info(*fp))
-		    if (d.info == (*fp)[5])
-		    {	//std::cout << "Match!" << std::endl;
-			d.fp = 1;
-			fpcount++;
-			delete[] *fp;
-			fps.erase(fp);
-			break;
-		    }
-		    else
-		    {	fpfile << "FP_ENTRY: " << (*fp)[0] << ';' << (*fp)[1] << ';' << (*fp)[2] << ';' << (*fp)[3] << ';' << (*fp)[4] << ';' << (*fp)[5] << '\n';
-			fpfile << "CHANGETO: " << (*fp)[0] << ';' << (*fp)[1] << ';' << (*fp)[2] << ';' << (*fp)[3] << ';' << (*fp)[4] << ';' << d.info << '\n';
-		    }
-	}
-	fpfile.close();
-	std::cout << '!' << std::endl;
-	std::cout << et.et() << "Found " << Datacheck::errors.size() << " datacheck errors and matched " << fpcount << " FP entries." << std::endl;
-}
-
 void Datacheck::unmatchedfps_log()
 {	// write log of unmatched false positives from datacheckfps.csv
 	std::ofstream fpfile(Args::logfilepath+"/unmatchedfps.log");
 	time_t timestamp = time(0);
 	fpfile << "Log file created at: " << ctime(&timestamp);
-	if (fps.empty()) fpfile << "No unmatched FP entries.\n";
-	else for (std::string* entry : fps)
-	     {	fpfile << entry[0] << ';' << entry[1] << ';' << entry[2] << ';' << entry[3] << ';' << entry[4] << ';' << entry[5] << '\n';
+	bool any = 0;
+	for (std::string* entry : fps)
+	  if (entry)
+	  {	fpfile << entry[0] << ';' << entry[1] << ';' << entry[2] << ';' << entry[3] << ';' << entry[4] << ';' << entry[5] << '\n';
 		delete[] entry;
-	     }
+		any = 1;
+	  }
+	if (!any) fpfile << "No unmatched FP entries.\n";
 	fpfile.close();
+	fps.clear();
+	fp_index.clear();
 }
 
 void Datacheck::datacheck_log()
@@ -129,11 +165,19 @@ void Datacheck::datacheck_log()
 	logfile.close();
 }
 
-bool operator < (const Datacheck &a, const Datacheck &b)
-{	return a.str() < b.str();
-}
+std::vector<std::string*> Datacheck::fps;
+std::unordered_map<std::string, std::vector<size_t>> Datacheck::fp_index;
 
-std::list<std::string*> Datacheck::fps;
+const char* const Datacheck::codes[]
+{	"ABBREV_AS_CHOP_BANNER", "ABBREV_AS_CON_BANNER", "ABBREV_NO_CITY", "BAD_ANGLE", "BUS_WITH_I",
+	"COMBINE_CON_ROUTES", "CON_BANNER_MISMATCH", "CON_ROUTE_MISMATCH", "DISCONNECTED_ROUTE",
+	"DUPLICATE_COORDS", "DUPLICATE_LABEL", "HIDDEN_JUNCTION", "HIDDEN_TERMINUS", "INTERSTATE_NO_HYPHEN",
+	"INVALID_FINAL_CHAR", "INVALID_FIRST_CHAR", "LABEL_INVALID_CHAR", "LABEL_LOOKS_HIDDEN",
+	"LABEL_LOWERCASE", "LABEL_PARENS", "LABEL_SELFREF", "LABEL_SLASHES", "LABEL_TOO_LONG",
+	"LABEL_UNDERSCORES", "LACKS_GENERIC", "LONG_SEGMENT", "LONG_UNDERSCORE", "LOWERCASE_SUFFIX",
+	"MALFORMED_LAT", "MALFORMED_LON", "MALFORMED_URL", "MULTI_REGION_OVERLAP", "NONTERMINAL_UNDERSCORE",
+	"OUT_OF_BOUNDS", "SHARP_ANGLE", "SINGLE_FIELD_LINE", "US_LETTER", "VISIBLE_DISTANCE", "VISIBLE_HIDDEN_COLOC"
+};
 
 std::unordered_set<std::string> Datacheck::always_error
 {	"ABBREV_AS_CHOP_BANNER",
@@ -1,19 +1,27 @@
 class ElapsedTime;
 class ErrorList;
 class Route;
+class Waypoint;
+#include <deque>
 #include <list>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 class Datacheck
 {   /* This class encapsulates a datacheck log entry
 
     route is a pointer to the route with a datacheck error
 
-    label1, label2 & label3 are labels that are related to the error
+    label1, label2 & label3 point to labels that are related to the error
     (such as the endpoints of a too-long segment or the three points
-    that form a sharp angle)
+    that form a sharp angle): those of the waypoints themselves, or
+    copies kept by the thread that added the error
+
+    code is one of the Code enum, and info is formatted from the
+    value stored with it only when needed
 
     code is the error code | info is additional
     string, one of:        | information, if used:
@@ -62,29 +70,61 @@ class Datacheck
     false positive (would be set to true later)
 
     */
+	// each thread's errors, and the strings they point to that aren't waypoint labels
+	struct Buffer
+	{	std::vector<Datacheck> errors;
+		std::deque<std::string> kept;
+	};
+	static std::list<Buffer> buffers;
+	static thread_local Buffer* buffer;
+	static Buffer& this_thread();
+	static std::string const none;
+
 	static std::mutex mtx;
-	static std::list<std::string*> fps;
+	static std::vector<std::string*> fps;	// in file order; deleted & nulled once matched
+	static std::unordered_map<std::string, std::vector<size_t>> fp_index;	// by all fields but info
 	static std::unordered_set<std::string> always_error;
+	static std::string fp_key(std::string const&, std::string const&, std::string const&, std::string const&, std::string const&);
+	static void fp_thread(int, std::vector<Datacheck*>*, std::string*, unsigned int*);
 	public:
+	enum Code : unsigned char
+	{	ABBREV_AS_CHOP_BANNER, ABBREV_AS_CON_BANNER, ABBREV_NO_CITY, BAD_ANGLE, BUS_WITH_I,
+		COMBINE_CON_ROUTES, CON_BANNER_MISMATCH, CON_ROUTE_MISMATCH, DISCONNECTED_ROUTE,
+		DUPLICATE_COORDS, DUPLICATE_LABEL, HIDDEN_JUNCTION, HIDDEN_TERMINUS, INTERSTATE_NO_HYPHEN,
+		INVALID_FINAL_CHAR, INVALID_FIRST_CHAR, LABEL_INVALID_CHAR, LABEL_LOOKS_HIDDEN,
+		LABEL_LOWERCASE, LABEL_PARENS, LABEL_SELFREF, LABEL_SLASHES, LABEL_TOO_LONG,
+		LABEL_UNDERSCORES, LACKS_GENERIC, LONG_SEGMENT, LONG_UNDERSCORE, LOWERCASE_SUFFIX,
+		MALFORMED_LAT, MALFORMED_LON, MALFORMED_URL, MULTI_REGION_OVERLAP, NONTERMINAL_UNDERSCORE,
+		OUT_OF_BOUNDS, SHARP_ANGLE, SINGLE_FIELD_LINE, US_LETTER, VISIBLE_DISTANCE, VISIBLE_HIDDEN_COLOC
+	};
+	static const char* const codes[];
+
 	Route *route;
-	std::string label1;
-	std::string label2;
-	std::string label3;
-	std::string code;
-	std::string info;
+	const std::string *label1, *label2, *label3;
+	union
+	{	const std::string* text;	// kept by the adding thread, or 0 for no info
+		Waypoint* point;		// root_at_label or coordinates, depending on code
+		Route* other;			// root of a concurrent route
+		double value;			// miles or degrees
+		size_t count;
+	};
+	Code code;
 	bool fp;
 
-	static std::list<Datacheck> errors;
-	static void add(Route*, std::string, std::string, std::string, std::string, std::string);
+	static std::vector<Datacheck> errors;	// all threads' errors, once sorted by mark_fps
+	static const std::string* keep(std::string&&);
+	static void add(Route*, const std::string*, const std::string*, const std::string*, Code, std::string&& = std::string());
+	static void add(Route*, const std::string*, const std::string*, const std::string*, Code, Waypoint*);
+	static void add(Route*, const std::string*, const std::string*, const std::string*, Code, Route*);
+	static void add(Route*, const std::string*, const std::string*, const std::string*, Code, double);
+	static void add(Route*, const std::string*, const std::string*, const std::string*, Code, size_t);
 	static void read_fps(ErrorList &);
 	static void mark_fps(ElapsedTime &);
 	static void unmatchedfps_log();
 	static void datacheck_log();
 
-	Datacheck(Route*, std::string, std::string, std::string, std::string, std::string);
+	Datacheck(Route*, const std::string*, const std::string*, const std::string*, Code);
 
-	bool match_except_info(std::string*);
+	std::string info() const;
 	std::string str() const;
 };
-
-bool operator < (const Datacheck &, const Datacheck &);
@@ -0,0 +1,87 @@
+#include "Datacheck.h"
+#include "../Args/Args.h"
+#include "../ElapsedTime/ElapsedTime.h"
+#include "../Route/Route.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#ifdef threading_enabled
+#include <thread>
+#endif
+
+void Datacheck::mark_fps(ElapsedTime &et)
+{	// gather all threads' errors, sorted by their datacheck.log lines, each built once
+	// and only for routes within the datacheck scope, if any
+	std::vector<std::pair<std::string, Datacheck*>> keys;
+	for (Buffer& b : buffers)
+	  for (Datacheck& d : b.errors)
+	    if (d.route->in_scope())
+		keys.emplace_back(d.str(), &d);
+	std::sort(keys.begin(), keys.end());
+	errors.reserve(keys.size());
+	for (auto& k : keys) errors.push_back(*k.second);
+	keys.clear();
+	keys.shrink_to_fit();
+	for (Buffer& b : buffers) std::vector<Datacheck>().swap(b.errors);
+
+	std::vector<Datacheck*> sorted;
+	sorted.reserve(errors.size());
+	for (Datacheck& d : errors) sorted.push_back(&d);
+	std::vector<std::string> log(Args::numthreads);
+	std::vector<unsigned int> fpcount(Args::numthreads, 0);
+      #ifdef threading_enabled
+	#define THRLP for (int t=0; t<Args::numthreads; t++) thr[t]
+	std::vector<std::thread> thr(Args::numthreads);
+	THRLP = std::thread(&Datacheck::fp_thread, t, &sorted, &log[t], &fpcount[t]);
+	THRLP.join();
+	#undef THRLP
+      #else
+	fp_thread(0, &sorted, &log[0], &fpcount[0]);
+      #endif
+
+	std::ofstream fpfile(Args::logfilepath+"/nearmatchfps.log");
+	time_t timestamp = time(0);
+	fpfile << "Log file created at: " << ctime(&timestamp);
+	for (std::string& l : log) fpfile << l;
+	fpfile.close();
+	for (int t = 1; t < Args::numthreads; t++) fpcount[0] += fpcount[t];
+	std::cout << '!' << std::endl;
+	std::cout << et.et() << "Found " << Datacheck::errors.size() << " datacheck errors and matched " << fpcount[0] << " FP entries." << std::endl;
+}
+
+void Datacheck::fp_thread(int t, std::vector<Datacheck*>* sorted, std::string* log, unsigned int* fpcount)
+{	// Errors differing only in info are adjacent once sorted, and only they can
+	// match the same FP entries, so each thread's share of errors begins & ends
+	// between runs of them. Within a run, an FP entry matched by one error is
+	// gone for the next, and near matches are logged in file order up to a match.
+	auto same = [](Datacheck* a, Datacheck* b)
+	{	return a->route == b->route && *a->label1 == *b->label1 && *a->label2 == *b->label2
+		    && *a->label3 == *b->label3 && a->code == b->code;
+	};
+	Datacheck** const data = sorted->data();
+	size_t const size = sorted->size();
+	size_t b = t*size/Args::numthreads;
+	size_t e = (t+1)*size/Args::numthreads;
+	while (b && b < size && same(data[b-1], data[b])) b++;
+	while (e && e < size && same(data[e-1], data[e])) e++;
+	for (size_t i = b; i < e; i++)
+	{	Datacheck& d = *data[i];
+		if (!t && (i+1) % (1000/Args::numthreads+1) == 0) std::cout << '.' << std::flush;
+		auto it = fp_index.find(fp_key(d.route->root, *d.label1, *d.label2, *d.label3, codes[d.code]));
+		if (it == fp_index.end()) continue;
+		for (size_t f : it->second)
+		{	std::string* fp = fps[f];
+			if (!fp) continue;
+			if (d.info() == fp[5])
+			{	d.fp = 1;
+				*fpcount += 1;
+				delete[] fp;
+				fps[f] = 0;
+				break;
+			}
+			std::string entry = fp[0] + ';' + fp[1] + ';' + fp[2] + ';' + fp[3] + ';' + fp[4] + ';';
+			*log += "FP_ENTRY: " + entry + fp[5] + '\n';
+			*log += "CHANGETO: " + entry + d.info() + '\n';
+		}
+	}
+}
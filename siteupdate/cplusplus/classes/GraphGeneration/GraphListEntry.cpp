@@ -3,10 +3,13 @@
 #include "PlaceRadius.h"
 #include "../HighwaySystem/HighwaySystem.h"
 #include "../Region/Region.h"
+#include <algorithm>
 #include <fmt/format.h>
 
 std::vector<GraphListEntry> GraphListEntry::entries;
-size_t GraphListEntry::num; // iterator for entries
+std::vector<size_t> GraphListEntry::order;
+size_t GraphListEntry::num; // iterator for order
+size_t GraphListEntry::reported;
 
 GraphListEntry::GraphListEntry(std::string r, std::string d, char f, char c, std::vector<Region*> *rg, std::vector<HighwaySystem*> *sys, PlaceRadius *pr):
 	regions(rg), systems(sys), placeradius(pr),
@@ -64,3 +67,34 @@ std::string GraphListEntry::tag()
 		default : return std::string("ERROR: GraphListEntry::tag() unexpected category token ('")+cat+"')";
 	}
 }
+
+size_t GraphListEntry::cost()
+{	// rough size of a subgraph: the vertices & edges of its
+	// regions, systems or area, whichever is least
+	size_t cost = -1;
+	if (regions)
+	{	size_t r_cost = 0;
+		for (Region* r : *regions) r_cost += r->vertices.count() + r->edges.count();
+		cost = std::min(cost, r_cost);
+	}
+	if (systems)
+	{	size_t s_cost = 0;
+		for (HighwaySystem* h : *systems) s_cost += h->vertices.count() + h->edges.count();
+		cost = std::min(cost, s_cost);
+	}
+	if (placeradius)
+		cost = std::min(cost, placeradius->vertices.count() + placeradius->edges.count());
+	return cost;
+}
+
+void GraphListEntry::schedule()
+{	// write the largest subgraphs first, so no thread is left with
+	// a big one at the end; ties keep their canonical order
+	std::vector<std::pair<size_t,size_t>> costs;
+	for (size_t g = 3; g < entries.size(); g += 3)
+		costs.emplace_back(entries[g].cost(), g);
+	std::stable_sort(costs.begin(), costs.end(),
+		[](const std::pair<size_t,size_t>& a, const std::pair<size_t,size_t>& b) {return a.first > b.first;});
+	order.clear();
+	for (auto& c : costs) order.push_back(c.second);
+}
@@ -14,6 +14,8 @@ class GraphListEntry
 	std::vector<Region*> *regions;
 	std::vector<HighwaySystem*> *systems;
 	PlaceRadius *placeradius;
+	std::string report;	// terminal output, once vertices & edges are counted
+	uint64_t hash;		// of file contents, for the graph manifest
 
 	// Info for the "graphs" DB table
 	std::string root;	std::string filename();
@@ -25,8 +27,12 @@ class GraphListEntry
 	char cat;		std::string category();
 
 	static std::vector<GraphListEntry> entries;
-	static size_t num; // iterator for entries
+	static std::vector<size_t> order; // subgraphs' entries, in the order they're written
+	static size_t num; // iterator for order
+	static size_t reported; // next entry to report, in canonical order
 	std::string tag();
+	size_t cost();
+	static void schedule();
 
 	GraphListEntry(std::string, std::string, char, char, std::vector<Region*>*, std::vector<HighwaySystem*>*, PlaceRadius*);
 	static void add_group(std::string&&,  std::string&&,  char, std::vector<Region*>*, std::vector<HighwaySystem*>*, PlaceRadius*);
@@ -1,8 +1,10 @@
 class HGVertex;
 class HighwaySegment;
 class HighwaySystem;
+class TMGWriter;
 #include <iostream>
-#include <list>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 class HGEdge
@@ -10,9 +12,17 @@ class HGEdge
     edge that can incorporate intermediate points.
     */
 	public:
-	std::string segment_name;
 	HGVertex *vertex1, *vertex2;
-	std::list<HGVertex*> intermediate_points; // if more than 1, will go from vertex1 to vertex2
+	HGVertex **intermediate_points;	// slice of HighwayGraph::shaping_points;
+	uint32_t num_points;		// if more than 1, will go from vertex1 to vertex2
+	const char *coords;		// " lat lng" for each intermediate point, in HighwayGraph::tmg_text
+	uint32_t coords_len;
+	const char *label;		// unrestricted by system, in HighwayGraph::tmg_text
+	uint16_t label_len;
+	bool mixed_systems;		// concurrent with active/preview routes of other systems;
+					// label can differ when restricted by system
+	uint64_t hash;			// of endpoints, coords & label
+	uint64_t traveled_hash;		// & travelers, if traveled
 	HighwaySegment *segment;
 	uint32_t c_idx; // index of last vertex collapsed, if applicable
 			// no "real" use, only for diagnostics & logging
@@ -25,14 +35,17 @@ class HGEdge
 
 	// this avoids adding more arguments to the collapse ctor
 	// and adding more ugly code to the collapse routine in the graph ctor
-	static HGVertex* v_array;	// for calculating c_idx
+	static HGVertex* v_array;	// for calculating c_idx & indexing vertex numbers
+
+	// labels of mixed_systems edges for one set of systems, where they differ from label
+	typedef std::unordered_map<HGEdge*, std::string> LabelMap;
 
 	HGEdge(HighwaySegment *);
-	HGEdge(HGVertex *, unsigned char, HGEdge*, HGEdge*);
+	HGEdge(HGVertex*, HGVertex*, HGVertex**, uint32_t, HighwaySegment*, HGVertex*, unsigned char);
 
-	void detach();
-	void collapsed_tmg_line(std::ofstream&, char*, unsigned int, std::vector<HighwaySystem*>*);
-	void traveled_tmg_line (std::ofstream&, char*, unsigned int, std::vector<HighwaySystem*>*, bool, char*);
+	void write_label(TMGWriter&, LabelMap*);
+	void collapsed_tmg_line(TMGWriter&, int*, LabelMap*);
+	void traveled_tmg_line (TMGWriter&, int*, unsigned int, LabelMap*, unsigned int, char*);
 	std::string debug_tmg_line(std::vector<HighwaySystem*> *, unsigned int);
 	std::string str();
 	std::string intermediate_point_string();
@@ -1,7 +1,5 @@
 #include "HGVertex.h"
-#include "../Args/Args.h"
 #include "../Datacheck/Datacheck.h"
-#include "../GraphGeneration/HGEdge.h"
 #include "../HighwaySystem/HighwaySystem.h"
 #include "../Region/Region.h"
 #include "../Route/Route.h"
@@ -9,15 +7,12 @@
 
 std::atomic_uint HGVertex::num_hidden(0);
 
-void HGVertex::setup(Waypoint *wpt, const std::string *n)
+void HGVertex::setup(Waypoint *wpt, const char *n)
 {	lat = wpt->lat;
 	lng = wpt->lng;
 	wpt->vertex = this;
-	s_vertex_num = new int[Args::numthreads];
-	c_vertex_num = new int[Args::numthreads];
-	t_vertex_num = new int[Args::numthreads];
-		       // deleted by ~HGVertex
 	unique_name = n;
+	incident_count = 0;
 	edge_count = 0;
 	visibility = 0;
 	    // permitted values:
@@ -37,32 +32,3 @@ void HGVertex::setup(Waypoint *wpt, const std::string *n)
 		visibility = 2;
 	else	num_hidden++;
 }
-
-HGVertex::~HGVertex()
-{	//std::cout << "deleting vertex at " << first_waypoint->str() << std::endl;
-	delete[] s_vertex_num;
-	delete[] c_vertex_num;
-	delete[] t_vertex_num;
-}
-
-HGEdge* HGVertex::front(unsigned char format)
-{	for (HGEdge* e : incident_edges)
-	  if (e->format & format)
-	    return e;
-	// Using this as intended with single-format bitmasks,
-	// we should never reach this point, because this function
-	// will only be called on vertices with edge_count of 2.
-	// Nonetheless, let's stop the compiler from complaining.
-	throw this;
-}
-
-HGEdge* HGVertex::back(unsigned char format)
-{	for (auto e = incident_edges.rbegin(); e != incident_edges.rend(); ++e)
-	  if ((*e)->format & format)
-	    return *e;
-	// Using this as intended with single-format bitmasks,
-	// we should never reach this point, because this function
-	// will only be called on vertices with edge_count of 2.
-	// Nonetheless, let's stop the compiler from complaining.
-	throw this;
-}
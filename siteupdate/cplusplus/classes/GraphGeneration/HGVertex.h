@@ -3,8 +3,6 @@ class HighwaySystem;
 class Region;
 class Waypoint;
 #include <atomic>
-#include <vector>
-#include <string>
 
 class HGVertex
 {   /* This class encapsulates information needed for a highway graph
@@ -12,19 +10,16 @@ class HGVertex
     */
 	public:
 	double lat, lng;
-	const std::string *unique_name;
-	std::vector<HGEdge*> incident_edges;
-	int *s_vertex_num;
-	int *c_vertex_num;
-	int *t_vertex_num;
-	uint16_t edge_count;
+	const char *unique_name;
+	const char *tmg_line;		// "name lat lng\n", in HighwayGraph::tmg_text
+	HGEdge** incident_edges;	// slice of HighwayGraph::adjacency
+	uint64_t hash;			// of tmg_line, to detect changed graphs
+	uint16_t tmg_len;
+	uint16_t incident_count;
+	uint16_t edge_count;		// simple edges only
 	char visibility;
 
 	static std::atomic_uint num_hidden;
 
-	void setup(Waypoint*, const std::string*);
-	~HGVertex();
-
-	HGEdge* front(unsigned char);
-	HGEdge* back (unsigned char);
+	void setup(Waypoint*, const char*);
 };
@@ -4,6 +4,7 @@
 #include "HGEdge.h"
 #include "HGVertex.h"
 #include "PlaceRadius.h"
+#include "TMGWriter.h"
 #include "../Args/Args.h"
 #include "../ElapsedTime/ElapsedTime.h"
 #include "../HighwaySegment/HighwaySegment.h"
@@ -13,10 +14,15 @@
 #include "../TravelerList/TravelerList.h"
 #include "../Waypoint/Waypoint.h"
 #include "../WaypointQuadtree/WaypointQuadtree.h"
+#include "../../functions/tmstring.h"
 #include "../../templates/contains.cpp"
+#include <algorithm>
+#include <cstring>
 #include <fmt/format.h>
 #include <fstream>
 #include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
 
 HighwayGraph::HighwayGraph(WaypointQuadtree &all_waypoints, ElapsedTime &et)
 {	unsigned int counter = 0;
@@ -29,108 +35,208 @@ HighwayGraph::HighwayGraph(WaypointQuadtree &all_waypoints, ElapsedTime &et)
 
 	// allocate vertices
 	vertices.resize(hi_priority_points.size()+lo_priority_points.size());
+	int const name_threads = Args::mtvertices ? Args::numthreads : 1;
+	vertex_names.alloc(vertices.size(), name_threads);
+	waypoint_naming_log.resize(2*name_threads);
 
 	std::cout << et.et() << "Creating unique names and vertices" << std::flush;
       #ifdef threading_enabled
 	#define THRLP for (int t=0; t<Args::numthreads; t++) thr[t]
 	std::vector<std::thread> thr(Args::numthreads);
 	if (Args::mtvertices)
-	{	THRLP = std::thread(&HighwayGraph::simplify, this, t, &hi_priority_points, &counter); THRLP.join();
-		THRLP = std::thread(&HighwayGraph::simplify, this, t, &lo_priority_points, &counter); THRLP.join();
+	{	std::vector<NameLogEntry>* log = waypoint_naming_log.data();
+		THRLP = std::thread(&HighwayGraph::simplify, this, t, &hi_priority_points, &counter, log+t); THRLP.join();
+		log += Args::numthreads;
+		THRLP = std::thread(&HighwayGraph::simplify, this, t, &lo_priority_points, &counter, log+t); THRLP.join();
 	} else
       #endif
-	{	simplify(0, &hi_priority_points, &counter);
-		simplify(0, &lo_priority_points, &counter);
+	{	simplify(0, &hi_priority_points, &counter, &waypoint_naming_log[0]);
+		simplify(0, &lo_priority_points, &counter, &waypoint_naming_log[1]);
 	}
 	std::cout << '!' << std::endl;
 	cv=tv=vertices.size();
 
-	std::cout << et.et() << "Estimating failsafe edge array size: " << std::flush;
-	size_t total_segments = 0;
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	  if (h.active_or_preview())
-	    for (Route& r : h.routes)
-	      total_segments += r.segments.size;
-	std::cout << total_segments << " total active/preview segments, "
-		  << HGVertex::num_hidden << " hidden vertices" << std::endl;
+	// count canonical segments per system, to assign each a contiguous block of the edge array
+	std::cout << et.et() << "Counting edges: " << std::flush;
+	std::vector<size_t> sys_offset(HighwaySystem::syslist.size);
+	HighwaySystem::it = HighwaySystem::syslist.begin();
+      #ifdef threading_enabled
+	THRLP = std::thread(&HighwaySystem::edge_thread, &log_mtx, nullptr, &sys_offset);
+	THRLP.join();
+      #else
+	HighwaySystem::edge_thread(&log_mtx, nullptr, &sys_offset);
+      #endif
+	for (size_t& o : sys_offset)
+	{	size_t const n = o;
+		o = se;
+		se += n;
+	}
+	// list them in edge array order, and count edges at each vertex in that same order,
+	// keeping the 1st 2 segments to find hidden vertex chains
+	std::vector<HighwaySegment*> canonical(se);
+	std::vector<IncidenceList> incidence(Args::numthreads*Args::numthreads);
+	std::vector<HighwaySegment*> vseg(2*vertices.size());
+	HighwaySystem::it = HighwaySystem::syslist.begin();
+      #ifdef threading_enabled
+	THRLP = std::thread(&HighwaySystem::edge_thread, &log_mtx, canonical.data(), &sys_offset);
+	THRLP.join();
+	THRLP = std::thread(&HighwayGraph::sort_incidence, this, t, &canonical, &incidence);
+	THRLP.join();
+	THRLP = std::thread(&HighwayGraph::count_incidence, this, t, &canonical, &incidence, &vseg);
+	THRLP.join();
+      #else
+	HighwaySystem::edge_thread(&log_mtx, canonical.data(), &sys_offset);
+	sort_incidence(0, &canonical, &incidence);
+	count_incidence(0, &canonical, &incidence, &vseg);
+      #endif
+	std::cout << se << " simple edges, " << HGVertex::num_hidden << " hidden vertices" << std::endl;
+
+	// determine which hidden vertices can be collapsed, and in which graphs
+	std::cout << et.et() << "Finding chains of hidden vertices" << std::flush;
+	ce=te=se;
+	for (HGVertex& v : vertices)
+	  if (!v.visibility)
+	  {	HighwaySegment** const s = vseg.data()+2*(&v-vertices.data());
+		// <2 edges = HIDDEN_TERMINUS or hidden U-turn
+		// >2 edges = HIDDEN_JUNCTION
+		// datachecks have been flagged earlier in the program; mark as visible and do not compress
+		// Segment name mismatches are likewise left uncompressed.
+		if (v.edge_count != 2 || !s[0]->same_ap_routes(s[1]))
+		{	v.visibility = 2;
+			continue;
+		}
+		--ce; --cv;
+		// if edge clinched_by sets mismatch, set visibility to 1
+		// (visible in traveled graph; hidden in collapsed graph)
+		if (s[0]->clinched_by != s[1]->clinched_by)
+			v.visibility = 1;
+		else {	--te; --tv;}
+	  }
+
+	// walk each chain of collapsible vertices, from one visible endpoint to the other
+	std::vector<HGVertex*> chains;		// each chain in path order, visible endpoints included
+	std::vector<size_t> chain_beg(1, 0);	// index of each chain's 1st vertex in chains
+	std::vector<bool> walked(vertices.size());
+	auto other_end = [](HighwaySegment* s, HGVertex* v)
+	{	HGVertex* const v1 = s->waypoint1->hashpoint()->vertex;
+		return v1 == v ? s->waypoint2->hashpoint()->vertex : v1;
+	};
+	auto walk = [&](HGVertex* v, HighwaySegment* from)
+	{	chains.push_back(other_end(from, v));
+		do {	walked[v-vertices.data()] = 1;
+			chains.push_back(v);
+			HighwaySegment** const s = vseg.data()+2*(v-vertices.data());
+			from = s[0] == from ? s[1] : s[0];
+			v = other_end(from, v);
+		   } while (v->visibility < 2);
+		chains.push_back(v);
+		chain_beg.push_back(chains.size());
+	};
+	for (HGVertex& v : vertices)
+	  if (v.visibility < 2 && !walked[&v-vertices.data()])
+	  {	HighwaySegment** const s = vseg.data()+2*(&v-vertices.data());
+		if	(other_end(s[0], &v)->visibility == 2) walk(&v, s[0]);
+		else if (other_end(s[1], &v)->visibility == 2) walk(&v, s[1]);
+	  }
+	// Closed loops of hidden vertices have no visible endpoint to collapse toward.
+	// Compressing serially, the loop's highest-indexed vertex went last, collapsing
+	// the edge running from it around the loop back to it into an edge whose
+	// endpoints were a vertex no graph lists. Stop just short of that instead:
+	// keep that vertex, and that edge, as compressing the rest of the loop left them.
+	for (HGVertex* v = vertices.data()+vertices.size(); v-- > vertices.data();)
+	  if (v->visibility < 2 && !walked[v-vertices.data()])
+	  {	if (!v->visibility) {++te; ++tv;}
+		++ce; ++cv;
+		v->visibility = 2;
+		HighwaySegment* const s = vseg[2*(v-vertices.data())];
+		HGVertex* const n = other_end(s, v);
+		if (n != v) walk(n, s);
+	  }
+	std::vector<bool>().swap(walked);
+	std::vector<HighwaySegment*>().swap(vseg);
+
+	// Each chain yields one collapsed edge, or if it contains vertices visible in the
+	// traveled graph, one collapsed edge plus one traveled edge per traveled sub-chain.
+	// Each edge goes where compressing vertices serially in index order would put it:
+	// after those created at lower-indexed vertices, collapsed edges before traveled.
+	// Count these edges at their endpoints too, and the shaping points they'll hold.
+	std::vector<uint32_t> slot(vertices.size());
+	std::vector<size_t> ip_beg(1, 0);	// index of each chain's 1st shaping point
+	for (size_t c = 0; c+1 < chain_beg.size(); c++)
+	{	HGVertex **const beg = chains.data()+chain_beg[c], **const end = chains.data()+chain_beg[c+1]-1;
+		slot[*std::max_element(beg+1, end)-vertices.data()]++;
+		beg[0]->incident_count++;
+		end[0]->incident_count++;
+		size_t points = end-beg-1;
+		if (std::find_if(beg+1, end, [](HGVertex* v){return v->visibility;}) != end)
+		  for (HGVertex** v = beg+1; v < end;)
+		    if (v[0]->visibility) v++;
+		    else {HGVertex* last = *v;
+			  v[-1]->incident_count++;
+			  for (; !v[0]->visibility; v++, points++)
+			    if (*v > last) last = *v;
+			  v[0]->incident_count++;
+			  slot[last-vertices.data()]++;
+			 }
+		ip_beg.push_back(ip_beg.back()+points);
+	}
+	size_t num_edges = se;
+	for (uint32_t& s : slot)
+	{	uint32_t const n = s;
+		s = num_edges;
+		num_edges += n;
+	}
+	std::cout << '!' << std::endl;
 
 	// create edges
-	counter = 0;
 	std::cout << et.et() << "Creating edges" << std::flush;
-	HGEdge* e = edges.alloc(total_segments + 2*HGVertex::num_hidden);
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	{	if (!h.active_or_preview()) continue;
-		if (counter % 6 == 0) std::cout << '.' << std::flush;
-		counter++;
-		for (Route& r : h.routes)
-		  for (HighwaySegment& s : r.segments)
-		    if (&s == s.canonical_edge_segment())
-		    { ++se; 
-		      new(e++) HGEdge(&s);
-		    }
+	HGEdge* e = edges.alloc(num_edges);
+	// lay out incident edge lists, simple edges followed by collapsed
+	size_t num_incident = 0;
+	for (HGVertex& v : vertices) num_incident += v.edge_count + v.incident_count;
+	HGEdge** a = adjacency.alloc(num_incident);
+	for (HGVertex& v : vertices)
+	{	v.incident_edges = a;
+		a += v.edge_count + v.incident_count;
+		v.incident_count = 0;
 	}
+	// construct simple edges, and populate incident edge lists with them in edge array order
+      #ifdef threading_enabled
+	THRLP = std::thread(&HighwayGraph::simple_edges, this, t, &canonical, &incidence);
+	THRLP.join();
+      #else
+	simple_edges(0, &canonical, &incidence);
+      #endif
+	std::vector<HighwaySegment*>().swap(canonical);
+	std::vector<IncidenceList>().swap(incidence);
 	std::cout << '!' << std::endl;
-	ce=te=se;
 
 	// compress edges adjacent to hidden vertices
-	counter = 0;
 	std::cout << et.et() << "Compressing collapsed edges" << std::flush;
 	HGEdge::v_array = vertices.data();
-	for (HGVertex& v : vertices)
-	{	if (counter % 10000 == 0) std::cout << '.' << std::flush;
-		counter++;
-		if (!v.visibility)
-		{	// <2 edges = HIDDEN_TERMINUS or hidden U-turn
-			// >2 edges = HIDDEN_JUNCTION
-			// datachecks have been flagged earlier in the program; mark as visible and do not compress
-			if (v.edge_count != 2)
-			{	v.visibility = 2;
-				continue;
-			}
-			if (!v.incident_edges[0]->segment->same_ap_routes(v.incident_edges[1]->segment))
-			{ /*	std::cout << "\nWARNING: segment name mismatch in HGEdge compression process" << std::endl;
-				std::cout << "  edge1: " << v.incident_edges[0]->segment->segment_name() << std::endl
-					  << "  edge2: " << v.incident_edges[1]->segment->segment_name() << std::endl;
-				std::cout << "  vertex " << *v.unique_name << " unhidden" << std::endl;
-				std::cout << "  waypoints:";
-				Waypoint* w = v.incident_edges[0]->segment->waypoint2;
-				if (w->lat != v.lat || w->lng != v.lng) w = v.incident_edges[0]->segment->waypoint1;
-				for (Waypoint* p : *w->colocated) std::cout << ' ' << p->root_at_label();
-				std::cout << std::endl; //*/
-				v.visibility = 2;
-				continue;
-			}
-			// construct from vertex this time
-			--ce; --cv;
-			// if edge clinched_by sets mismatch, set visibility to 1
-			// (visible in traveled graph; hidden in collapsed graph)
-			uint8_t const coll = HGEdge::collapsed, trav = HGEdge::traveled, dual = coll|trav;
-			HGEdge* const t_front = v.front(trav);
-			HGEdge* const t_back  = v.back (trav);
-			if (t_front->segment->clinched_by != t_back->segment->clinched_by)
-			{	v.visibility = 1;
-				new(e++) HGEdge(&v, coll, v.front(coll), v.back(coll));
-				continue;
-			}
-			if (t_front->format & coll && t_back->format & coll)
-				new(e++) HGEdge(&v, dual, t_front, t_back);
-			else {	new(e++) HGEdge(&v, coll, v.front(coll), v.back(coll));
-				new(e++) HGEdge(&v, trav, t_front, t_back);
-			     }
-			--te; --tv;
-		}
+	shaping_points.alloc(ip_beg.back());
+	std::atomic<size_t> constructions(0);
+      #ifdef threading_enabled
+	THRLP = std::thread(&HighwayGraph::collapse, this, t, &chains, &chain_beg, &ip_beg, &slot, &constructions);
+	THRLP.join();
+      #else
+	collapse(0, &chains, &chain_beg, &ip_beg, &slot, &constructions);
+      #endif
+	// visible endpoints are shared between chains; add collapsed edges to them now
+	for (e = edges.data+se; e < edges.end(); e++)
+	{	e->vertex1->incident_edges[e->vertex1->incident_count++] = e;
+		e->vertex2->incident_edges[e->vertex2->incident_count++] = e;
 	}
+	vertex_num.resize(Args::numthreads);
+	tmg_buf.resize(Args::numthreads);
 	std::cout << '!' << std::endl;
-	edges.size = e - edges.data;
 
 	if (Args::edgecounts)
 	{	std::cout << et.et() << "Edge format counts:" << std::endl;
 		int fcount[8] = {0,0,0,0,0,0,0,0};
 		for (HGEdge& e : edges) fcount[e.format]++;
-		int const allocated = total_segments + 2*HGVertex::num_hidden;
-		int const live = edges.size-fcount[0];
 		double constexpr edge_mb = sizeof(HGEdge)/double(1048576);
-		printf("%10i format 0 (temporary, partially collapsed)\n", fcount[0]);
+		printf("%10li format 0 (partially collapsed; never constructed)\n", constructions-(edges.size-se));
 		printf("%10i format 1 (simple)\n", fcount[1]);
 		printf("%10i format 2 (collapsed)\n", fcount[2]);
 		printf("%10i format 3 (simple + collapsed -- this should always be 0)\n", fcount[3]);
@@ -139,11 +245,8 @@ HighwayGraph::HighwayGraph(WaypointQuadtree &all_waypoints, ElapsedTime &et)
 		printf("%10i format 6 (collapsed + traveled)\n", fcount[6]);
 		printf("%10i format 7 (simple + collapsed + traveled)\n", fcount[7]);
 		printf("-----------------------------------------------------------------\n");
-		printf("%10i collapse constructions performed\n", fcount[0]+fcount[2]+fcount[4]+fcount[6]);
-		printf("%10i live edges\t\t(%.2f MB)\n", live, live*edge_mb);
-		printf("%10li total objects\t(%.2f MB)\n", edges.size, edges.size*edge_mb);
-		printf("%10li allocated but unused\t(%.2f MB)\n", allocated-edges.size, (allocated-edges.size)*edge_mb);
-		printf("%10i allocated in total\t(%.2f MB)\n", allocated, allocated*edge_mb);
+		printf("%10li collapse operations performed\n", size_t(constructions));
+		printf("%10li live edges\t\t(%.2f MB)\n", edges.size, edges.size*edge_mb);
 		fflush(stdout);
 	}
 
@@ -161,11 +264,60 @@ HighwayGraph::HighwayGraph(WaypointQuadtree &all_waypoints, ElapsedTime &et)
       #ifdef threading_enabled
 	THRLP = std::thread(&HighwaySystem::ve_thread, &log_mtx, &vertices, &edges);
 	THRLP.join();
-	#undef THRLP
       #else
 	HighwaySystem::ve_thread(&log_mtx, &vertices, &edges);
       #endif
 
+	for (size_t g = 3; g < GraphListEntry::entries.size(); g += 3)
+	  if (GraphListEntry::entries[g].placeradius)
+	    PlaceRadius::all.push_back(GraphListEntry::entries[g].placeradius);
+	if (PlaceRadius::all.size())
+	{	std::cout << et.et() << "Creating per-area vertex & edge sets." << std::endl;
+		PlaceRadius::trig.resize(vertices.size());
+	      #ifdef threading_enabled
+		THRLP = std::thread(&PlaceRadius::trig_thread, t, &vertices); THRLP.join();
+		THRLP = std::thread(&PlaceRadius::ve_thread, t, &vertices, &edges, &all_waypoints); THRLP.join();
+	      #else
+		PlaceRadius::trig_thread(0, &vertices);
+		PlaceRadius::ve_thread(0, &vertices, &edges, &all_waypoints);
+	      #endif
+		std::vector<PlaceRadius::Trig>().swap(PlaceRadius::trig);
+	}
+
+	for (TravelerList& t : TravelerList::allusers)
+		traveler_hash.push_back(hash_bytes(t.traveler_name.data(), t.traveler_name.size(), 0));
+
+	// format vertex lines, shaping point coords & edge labels once, for all graphs,
+	// and hash them to detect graphs that haven't changed since the last run
+	std::cout << et.et() << "Formatting vertices, edge coordinates & labels." << std::endl;
+	tmg_text.resize(2*Args::numthreads);
+	// subgraphs restricted by identical sets of systems share their labels
+	std::vector<std::vector<HighwaySystem*>> label_sets;
+	std::vector<size_t> set_num;
+	for (size_t g = 3; g < GraphListEntry::entries.size(); g += 3)
+	{	std::vector<HighwaySystem*>* systems = GraphListEntry::entries[g].systems;
+		if (!systems) continue;
+		std::vector<HighwaySystem*> sorted(*systems);
+		std::sort(sorted.begin(), sorted.end());
+		size_t i = std::find(label_sets.begin(), label_sets.end(), sorted) - label_sets.begin();
+		if (i == label_sets.size()) label_sets.emplace_back(std::move(sorted));
+		set_num.push_back(i);
+	}
+	label_maps.resize(label_sets.size());
+	for (size_t g = 3, i = 0; g < GraphListEntry::entries.size(); g += 3)
+	  if (GraphListEntry::entries[g].systems)
+	    restricted_labels[GraphListEntry::entries[g].systems] = &label_maps[set_num[i++]];
+      #ifdef threading_enabled
+	THRLP = std::thread(&HighwayGraph::format_vertices, this, t); THRLP.join();
+	THRLP = std::thread(&HighwayGraph::format_edges,    this, t); THRLP.join();
+	THRLP = std::thread(&HighwayGraph::restrict_labels, this, t, &label_sets); THRLP.join();
+	#undef THRLP
+      #else
+	format_vertices(0);
+	format_edges(0);
+	restrict_labels(0, &label_sets);
+      #endif
+
 	if (Args::bitsetlogs)
 	{	std::cout << et.et() << "Writing TMBitset logs. " << hi_priority_points.size()
 			  << " hi_priority_points / " << vertices.size() << " total vertices" << std::endl;
@@ -175,22 +327,10 @@ HighwayGraph::HighwayGraph(WaypointQuadtree &all_waypoints, ElapsedTime &et)
 	std::cout << et.et() << "Master graph construction complete. Destroying temporary variables." << std::endl;
 } // end ctor
 
-inline std::pair<std::unordered_set<std::string>::iterator,bool> HighwayGraph::vertex_name(std::string& n)
-{	set_mtx[n.back()].lock();
-	std::pair<std::unordered_set<std::string>::iterator,bool> insertion = vertex_names[n.back()].insert(n);
-	set_mtx[n.back()].unlock();
-	return insertion;
-}
-
-void HighwayGraph::namelog(std::string&& msg)
-{	log_mtx.lock();
-	waypoint_naming_log.emplace_back(msg);
-	log_mtx.unlock();
-}
-
-void HighwayGraph::simplify(int t, VInfoVec* points, unsigned int *counter)
+void HighwayGraph::simplify(int t, VInfoVec* points, unsigned int *counter, std::vector<NameLogEntry>* log)
 {	// create unique names and vertices
 	int numthreads = Args::mtvertices ? Args::numthreads : 1;
+	std::string point_name, simple_name;	// reused from one point to the next
 	auto end = (t+1)*points->size()/numthreads+points->data();
 	for (auto vi = t*points->size()/numthreads+points->data(); vi < end; vi++)
 	{	// progress indicator
@@ -200,37 +340,205 @@ void HighwayGraph::simplify(int t, VInfoVec* points, unsigned int *counter)
 		}
 
 		// start with the canonical name and attempt to insert into vertex_names set
-		std::string point_name = vi->first->canonical_waypoint_name(this);
-		std::pair<std::unordered_set<std::string>::iterator,bool> insertion = vertex_name(point_name);
+		NameLogEntry entry = {vi->first, 0, 0, 0, 0, 0};
+		entry.rule = vi->first->canonical_waypoint_name(point_name, this, &entry.taken);
+		std::pair<const char*,bool> insertion = vertex_names.insert(point_name, t);
 
 		// if that's taken, append the region code
 		if (!insertion.second)
-		{	point_name += "|" + vi->first->route->region->code;
-			namelog("Appended region: " + point_name);
-			insertion = vertex_name(point_name);
+		{	point_name += '|';
+			point_name += vi->first->route->region->code;
+			insertion = vertex_names.insert(point_name, t);
+			entry.regional = insertion.first;
 		}
 
 		// if that's taken, see if the simple name is available
 		if (!insertion.second)
-		{	std::string simple_name = vi->first->simple_waypoint_name();
-			insertion = vertex_name(simple_name);
+		{	vi->first->simple_waypoint_name(simple_name);
+			insertion = vertex_names.insert(simple_name, t);
 			if (insertion.second)
-				namelog("Revert to simple: " + simple_name + " from (taken) " + point_name);
+				entry.reverted = 1;
 			else do // if we have not yet succeeded, add !'s until we do
-			{	point_name += "!";
-				namelog("Appended !: " + point_name);
-				insertion = vertex_name(point_name);
+			{	point_name += '!';
+				entry.bangs++;
+				insertion = vertex_names.insert(point_name, t);
 			} while (!insertion.second);
 		}
 
 		// we're good; now set up a vertex
-		vertices[vi->second].setup(vi->first, &*(insertion.first));
+		vertices[vi->second].setup(vi->first, insertion.first);
+		if (entry.rule || entry.regional) log->push_back(entry);
 
 		// active/preview colocation lists are no longer needed; clear them
 		vi->first->ap_coloc.clear();
 	}
 }
 
+void HighwayGraph::write_naming_log(std::ofstream& file)
+{	// entries are in the order vertices were named in single-threaded mode
+	static const char* const rule_names[] =
+	{	"", "Keep_failsafe", "Straightforward_intersection", "Straightforward_concurrency",
+		"Exit/Intersection", "Exit_number", "3+_intersection", "Reversed_border_labels"
+	};
+	std::string simple_name;
+	for (std::vector<NameLogEntry>& log : waypoint_naming_log)
+	{ for (NameLogEntry& e : log)
+	  {	if (e.rule)
+		{	e.wpt->simple_waypoint_name(simple_name);
+			file << rule_names[e.rule] << ": " << simple_name;
+			if (e.rule != keep_failsafe)
+			{	// the canonical name is the vertex's name, or the regional name less its region code
+				file << " -> ";
+				if (e.regional)
+					file.write(e.regional, strlen(e.regional) - e.wpt->route->region->code.size() - 1);
+				else	file << e.wpt->vertex->unique_name;
+				if (e.taken) file << " (" << e.taken << " already taken)";
+			}
+			file << '\n';
+		}
+		if (e.regional)
+		{	file << "Appended region: " << e.regional << '\n';
+			if (e.reverted)
+			{	e.wpt->simple_waypoint_name(simple_name);
+				file << "Revert to simple: " << simple_name << " from (taken) " << e.regional << '\n';
+			}
+			for (uint16_t b = 1; b <= e.bangs; b++)
+			{	file << "Appended !: " << e.regional;
+				for (uint16_t i = 0; i < b; i++) file << '!';
+				file << '\n';
+			}
+		}
+	  }
+	  std::vector<NameLogEntry>().swap(log);
+	}
+}
+
+void HighwayGraph::sort_incidence(int t, std::vector<HighwaySegment*>* canonical, std::vector<IncidenceList>* incidence)
+{	// sort the endpoints of this thread's share of the simple edges into
+	// buckets by the thread whose range of vertex indices they fall in
+	size_t const nt = Args::numthreads, nv = vertices.size();
+	IncidenceList* const buckets = incidence->data()+t*nt;
+	for (size_t i = t*canonical->size()/nt, end = (t+1)*canonical->size()/nt; i < end; i++)
+	  for (Waypoint* w : {(*canonical)[i]->waypoint1, (*canonical)[i]->waypoint2})
+	  {	size_t const vi = w->hashpoint()->vertex-vertices.data();
+		buckets[vi*nt/nv].emplace_back(vi, i);
+	  }
+}
+
+void HighwayGraph::count_incidence(int t, std::vector<HighwaySegment*>* canonical, std::vector<IncidenceList>* incidence, std::vector<HighwaySegment*>* vseg)
+{	// count edges at this thread's range of vertices, reading the buckets
+	// of each thread in turn to visit them in edge array order
+	for (size_t b = t; b < incidence->size(); b += Args::numthreads)
+	  for (std::pair<uint32_t,uint32_t>& inc : (*incidence)[b])
+	  {	HGVertex& v = vertices[inc.first];
+		if (v.edge_count < 2) (*vseg)[2*inc.first+v.edge_count] = (*canonical)[inc.second];
+		v.edge_count++;
+	  }
+}
+
+void HighwayGraph::simple_edges(int t, std::vector<HighwaySegment*>* canonical, std::vector<IncidenceList>* incidence)
+{	size_t const nt = Args::numthreads;
+	for (size_t i = t*canonical->size()/nt, end = (t+1)*canonical->size()/nt; i < end; i++)
+		new(edges.data+i) HGEdge((*canonical)[i]);
+	for (size_t b = t; b < incidence->size(); b += nt)
+	  for (std::pair<uint32_t,uint32_t>& inc : (*incidence)[b])
+	  {	HGVertex& v = vertices[inc.first];
+		v.incident_edges[v.incident_count++] = edges.data+inc.second;
+	  }
+}
+
+void HighwayGraph::collapse(int t, std::vector<HGVertex*>* chains, std::vector<size_t>* chain_beg, std::vector<size_t>* ip_beg, std::vector<uint32_t>* slot, std::atomic<size_t>* constructions)
+{	// Collapse each chain of hidden vertices independently. Partially-collapsed
+	// edges are tracked only by the span of the chain's path they cover;
+	// those remaining once the chain is done are constructed in their slots.
+	struct piece
+	{	HighwaySegment* segment;
+		HGVertex* vertex;	// vertex collapsed, if not an original simple edge
+		size_t key;		// order in its endpoints' incident edge lists
+		uint32_t lo, hi;	// path positions of endpoints
+		unsigned char format;
+		bool fwd;		// vertex1 is at lo
+	};
+	uint8_t const coll = HGEdge::collapsed, trav = HGEdge::traveled, dual = coll|trav;
+	std::vector<piece> pieces;
+	std::vector<uint32_t> order, c_left, c_right, t_left, t_right;
+	auto merge = [&](HGVertex** path, uint32_t p, uint32_t l, uint32_t r, unsigned char fmt)
+	{	// as per collapsing 2 edges serially: vertex1 & the segment come
+		// from the edge appearing first in path[p]'s incident edge list
+		piece const& L = pieces[l];
+		piece const& R = pieces[r];
+		bool const fwd = L.key < R.key;
+		piece const n = {(fwd ? L : R).segment, path[p], se+pieces.size(), L.lo, R.hi, fmt, fwd};
+		pieces[l].format &= ~fmt;
+		pieces[r].format &= ~fmt;
+		if (fmt & coll) c_right[n.lo] = c_left[n.hi] = pieces.size();
+		if (fmt & trav) t_right[n.lo] = t_left[n.hi] = pieces.size();
+		pieces.push_back(n);
+	};
+	size_t const n = chain_beg->size()-1;
+	size_t const end = (t+1)*n/Args::numthreads;
+	for (size_t c = t*n/Args::numthreads; c < end; c++)
+	{	if (!t && c % 10000 == 0) std::cout << '.' << std::flush;
+		HGVertex** const path = chains->data()+(*chain_beg)[c];
+		uint32_t const k = (*chain_beg)[c+1]-(*chain_beg)[c]-1;
+		// path[0] & path[k] are visible; simple edge i goes from path[i] to path[i+1].
+		// A hidden vertex's 1st 2 incident edges are its simple edges.
+		// Each chain has at least 1 hidden vertex between its visible ends,
+		// so k >= 2 and the loop below always sets left.
+		pieces.clear();
+		HGEdge* left = nullptr;
+		auto original = [&](uint32_t i, HGEdge* e)
+		{	pieces.push_back({e->segment, 0, size_t(e-edges.data), i, i+1, e->format, e->vertex1 == path[i]});
+		};
+		for (uint32_t p = 1; p < k; p++)
+		{	HGEdge** const o = path[p]->incident_edges;
+			left = o[0]->vertex1 == path[p-1] || o[0]->vertex2 == path[p-1] ? o[0] : o[1];
+			original(p-1, left);
+		}
+		HGEdge** const o = path[k-1]->incident_edges;
+		original(k-1, o[0] == left ? o[1] : o[0]);
+		c_left.resize(k+1); c_right.resize(k+1);
+		t_left.resize(k+1); t_right.resize(k+1);
+		for (uint32_t i = 0; i < k; i++)
+		{	c_right[i] = t_right[i] = i;
+			c_left[i+1] = t_left[i+1] = i;
+		}
+
+		// compress vertices in index order, for the same edge orientations
+		// & segments as compressing the whole graph serially would yield
+		order.resize(k-1);
+		for (uint32_t p = 1; p < k; p++) order[p-1] = p;
+		std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){return path[a] < path[b];});
+		for (uint32_t p : order)
+		  if (path[p]->visibility)
+			merge(path, p, c_left[p], c_right[p], coll);
+		  else {uint32_t const l = t_left[p], r = t_right[p];
+			if (pieces[l].format & coll && pieces[r].format & coll)
+				merge(path, p, l, r, dual);
+			else {	merge(path, p, c_left[p], c_right[p], coll);
+				merge(path, p, l, r, trav);
+			     }
+		       }
+
+		// original edges keep their simple format; construct the surviving new ones
+		for (uint32_t i = 0; i < k; i++)
+		  edges[pieces[i].key].format = pieces[i].format;
+		HGVertex** ip = shaping_points.data+(*ip_beg)[c];
+		for (piece* p = pieces.data()+k; p < pieces.data()+pieces.size(); p++)
+		  if (p->format)
+		  {	uint32_t const np = p->hi-p->lo-1;
+			if (p->fwd) std::copy(path+p->lo+1, path+p->hi, ip);
+			else std::reverse_copy(path+p->lo+1, path+p->hi, ip);
+			new(edges.data+(*slot)[p->vertex-vertices.data()]++) HGEdge
+			(	path[p->fwd ? p->lo : p->hi], path[p->fwd ? p->hi : p->lo],
+				ip, np, p->segment, p->vertex, p->format
+			);
+			ip += np;
+		  }
+		*constructions += pieces.size()-k;
+	}
+}
+
 void HighwayGraph::bitsetlogs(HGVertex* hp_end)
 {	size_t oldvheap = sizeof(uint64_t) * ceil(double(vertices.size()+1)/(sizeof(uint64_t)*8));
 	size_t oldeheap = sizeof(uint64_t) * ceil(double(edges.size+1)/(sizeof(uint64_t)*8));
@@ -248,7 +556,7 @@ void HighwayGraph::bitsetlogs(HGVertex* hp_end)
 	}
 	std::cout << "final_s = " << final_s << ": " << edges[final_s].str() << std::endl;
 	std::cout << "first_c = " << first_c << ": " << edges[first_c].str() << std::endl;
-	std::cout << "low_pri = " << low_pri << ": " << edges[low_pri].str() << " ~~ " << *hp_end->unique_name << std::endl;
+	std::cout << "low_pri = " << low_pri << ": " << edges[low_pri].str() << " ~~ " << hp_end->unique_name << std::endl;
 	std::cout << "total_e = " << edges.size << std::endl;
 
 	std::ofstream vramlog(Args::logfilepath+"/tmb-region-vram.csv");
@@ -275,10 +583,10 @@ void HighwayGraph::bitsetlogs(HGVertex* hp_end)
 			prev = v;
 		}
 		vgaplog << code
-			<< ';' << lo_v-start << ';' << *lo_v->unique_name << ';' << gap
-			<< ';' << lo_g-start << ';' << *lo_g->unique_name << ';' << (lo_g < hp_end ? "hi" : "lo")
-			<< ';' << hi_g-start << ';' << *hi_g->unique_name << ';' << (hi_g < hp_end ? "hi" : "lo")
-			<< ';' << hi_v-start << ';' << *hi_v->unique_name << std::endl;
+			<< ';' << lo_v-start << ';' << lo_v->unique_name << ';' << gap
+			<< ';' << lo_g-start << ';' << lo_g->unique_name << ';' << (lo_g < hp_end ? "hi" : "lo")
+			<< ';' << hi_g-start << ';' << hi_g->unique_name << ';' << (hi_g < hp_end ? "hi" : "lo")
+			<< ';' << hi_v-start << ';' << hi_v->unique_name << std::endl;
 	};
 	auto egaplogline=[&](TMBitset<HGEdge*,uint64_t>& tmb, std::string& code, HGEdge* start)
 	{	HGEdge *lo_e, *hi_e, *lo_g1, *hi_g1, *lo_g2, *hi_g2, *prev;
@@ -349,76 +657,190 @@ void HighwayGraph::bitsetlogs(HGVertex* hp_end)
 	}
 }
 
+void HighwayGraph::format_vertices(int t)
+{	// each vertex's tmg line, for thread t's share of vertices
+	std::string& text = tmg_text[t];
+	HGVertex* const beg = vertices.data() + t*vertices.size()/Args::numthreads;
+	HGVertex* const end = vertices.data() + (t+1)*vertices.size()/Args::numthreads;
+	std::vector<size_t> offset(end-beg);
+	char fstr[58];
+	for (HGVertex* v = beg; v < end; v++)
+	{	offset[v-beg] = text.size();
+		text += v->unique_name;
+		*fmt::format_to(fstr, " {:.15} {:.15}\n", v->lat, v->lng) = 0;
+		text += fstr;
+		v->tmg_len = text.size() - offset[v-beg];
+	}
+	// text won't move anymore
+	for (HGVertex* v = beg; v < end; v++)
+	{	v->tmg_line = text.data() + offset[v-beg];
+		v->hash = hash_bytes(v->tmg_line, v->tmg_len, 0);
+	}
+}
+
+void HighwayGraph::format_edges(int t)
+{	// shaping point coords & unrestricted label for thread t's share of edges,
+	// coords copied from the tmg lines of the vertices they come from
+	std::string& text = tmg_text[Args::numthreads+t];
+	HGEdge* const beg = edges.data + t*edges.size/Args::numthreads;
+	HGEdge* const end = edges.data + (t+1)*edges.size/Args::numthreads;
+	std::vector<size_t> offset(end-beg);
+	for (HGEdge* e = beg; e < end; e++)
+	{	offset[e-beg] = text.size();
+		for (HGVertex **p = e->intermediate_points, **p_end = p+e->num_points; p < p_end; p++)
+		{	size_t const name_len = strlen((*p)->unique_name);
+			text.append((*p)->tmg_line + name_len, (*p)->tmg_len - name_len - 1);
+		}
+		e->coords_len = text.size() - offset[e-beg];
+		e->segment->append_label(text, 0);
+		e->label_len = text.size() - offset[e-beg] - e->coords_len;
+		e->mixed_systems = e->segment->mixed_systems();
+	}
+	for (HGEdge* e = beg; e < end; e++)
+	{	e->coords = text.data() + offset[e-beg];
+		e->label = e->coords + e->coords_len;
+		e->hash = hash_bytes(e->coords, e->coords_len + e->label_len, 0);
+		e->hash = mix(e->hash ^ e->vertex1->hash);
+		e->hash = mix(e->hash ^ e->vertex2->hash);
+		e->traveled_hash = e->hash;
+		if (e->format & HGEdge::traveled)
+		  for (TravelerList* t : e->segment->clinched_by)
+		    e->traveled_hash = mix(e->traveled_hash ^ traveler_hash[t-TravelerList::allusers.data]);
+	}
+}
+
+void HighwayGraph::restrict_labels(int t, std::vector<std::vector<HighwaySystem*>>* label_sets)
+{	// labels of edges restricted by each of thread t's share of system sets,
+	// stored only where they differ from the unrestricted label
+	std::string label;
+	for (size_t i = t; i < label_sets->size(); i += Args::numthreads)
+	{	std::vector<HighwaySystem*>& systems = (*label_sets)[i];
+		HGEdge::LabelMap& labels = label_maps[i];
+		for (HighwaySystem* h : systems)
+		  for (HGEdge* e : h->edges)
+		    if (e->mixed_systems && !labels.count(e))
+		    {	label.clear();
+			e->segment->append_label(label, &systems);
+			if (label.compare(0, label.size(), e->label, e->label_len))
+				labels.emplace(e, label);
+		    }
+	}
+}
+
+int* HighwayGraph::vertex_nums(unsigned int threadnum)
+{	// simple, collapsed & traveled vertex numbers, indexed by vertex,
+	// owned by one thread & allocated on its first graph
+	std::vector<int>& n = vertex_num[threadnum];
+	if (n.empty()) n.resize(3*vertices.size());
+	return n.data();
+}
+
+char* HighwayGraph::tmg_buffers(unsigned int threadnum)
+{	// simple, collapsed & traveled file buffers,
+	// owned by one thread & allocated on its first graph
+	std::vector<char>& b = tmg_buf[threadnum];
+	if (b.empty()) b.resize(3*TMGWriter::bufsize);
+	return b.data();
+}
+
 // write the entire set of highway data in .tmg format.
 // The first line is a header specifying the format and version number,
 // The second line specifies the number of waypoints, w, the number of connections, c,
 //     and for traveled graphs only, the number of travelers.
 // Then, w lines describing waypoints (label, latitude, longitude).
 // Then, c lines describing connections (endpoint 1 number, endpoint 2 number, route label),
-//     followed on traveled graphs only by a hexadecimal code encoding travelers on that segment,
+//     followed on traveled graphs only by a hexadecimal code encoding travelers on that segment
+//     (TMG 2.0), or with --tmg3, its travelers as runs of traveler numbers (TMG 3.0),
 //     followed on both collapsed & traveled graphs by a list of latitude & longitude values
 //     for intermediate "shaping points" along the edge, ordered from endpoint 1 to endpoint 2.
 //
 void HighwayGraph::write_master_graphs_tmg()
-{	std::ofstream simplefile(Args::graphfilepath + "/tm-master-simple.tmg");
-	std::ofstream collapfile(Args::graphfilepath + "/tm-master.tmg");
-	std::ofstream travelfile(Args::graphfilepath + "/tm-master-traveled.tmg");
-	simplefile << "TMG 1.0 simple\n";
-	collapfile << "TMG 1.0 collapsed\n";
-	travelfile << "TMG 2.0 traveled\n";
-	simplefile << vertices.size() << ' ' << se << '\n';
-	collapfile << cv << ' ' << ce << '\n';
-	travelfile << tv << ' ' << te << ' ' << TravelerList::allusers.size << '\n';
+{	GraphListEntry* g = GraphListEntry::entries.data();
+	g[0].vertices = vertices.size(); g[0].edges = se; g[0].travelers = 0;
+	g[1].vertices = cv;		 g[1].edges = ce; g[1].travelers = 0;
+	g[2].vertices = tv;		 g[2].edges = te; g[2].travelers = TravelerList::allusers.size;
+	// hash each format's contents; only the traveled graph depends on travelers
+	uint64_t s_hash = 0, c_hash = 0, t_hash = Args::tmg3;
+	for (HGVertex& v : vertices)
+	  switch (v.visibility) // fall-thru is a Good Thing!
+	  {	case 2:	 c_hash = mix(c_hash ^ v.hash);
+		case 1:	 t_hash = mix(t_hash ^ v.hash);
+		default: s_hash = mix(s_hash ^ v.hash);
+	  }
+	for (HGEdge& e : edges)
+	{	if (e.format & HGEdge::simple)	  s_hash = mix(s_hash ^ e.hash);
+		if (e.format & HGEdge::collapsed) c_hash = mix(c_hash ^ e.hash);
+		if (e.format & HGEdge::traveled)  t_hash = mix(t_hash ^ e.traveled_hash);
+	}
+	for (uint64_t h : traveler_hash) t_hash = mix(t_hash ^ h);
+	g[0].hash = s_hash;
+	g[1].hash = c_hash;
+	g[2].hash = t_hash;
+	unsigned char const formats = ~unchanged(g) & 7; // to write
+	if (!formats) return;
+
+	char* const buf = tmg_buffers(0);
+	TMGWriter simplefile(buf);
+	TMGWriter collapfile(buf + TMGWriter::bufsize);
+	TMGWriter travelfile(buf + 2*TMGWriter::bufsize);
+	if (formats & HGEdge::simple)	 simplefile.open(Args::graphfilepath + "/tm-master-simple.tmg");
+	if (formats & HGEdge::collapsed) collapfile.open(Args::graphfilepath + "/tm-master.tmg");
+	if (formats & HGEdge::traveled)	 travelfile.open(Args::graphfilepath + "/tm-master-traveled.tmg");
+	simplefile.write("TMG 1.0 simple\n", 15);
+	collapfile.write("TMG 1.0 collapsed\n", 18);
+	travelfile.write(Args::tmg3 ? "TMG 3.0 traveled\n" : "TMG 2.0 traveled\n", 17);
+	simplefile.num(vertices.size());	simplefile.put(' ');
+	simplefile.num(se);			simplefile.put('\n');
+	collapfile.num(cv);			collapfile.put(' ');
+	collapfile.num(ce);			collapfile.put('\n');
+	travelfile.num(tv);			travelfile.put(' ');
+	travelfile.num(te);			travelfile.put(' ');
+	travelfile.num(TravelerList::allusers.size); travelfile.put('\n');
 
 	// write vertices
 	unsigned int sv = 0;
 	unsigned int cv = 0;
 	unsigned int tv = 0;
-	char fstr[57];
-	for (HGVertex& v : vertices)
-	{	*fmt::format_to(fstr, " {:.15} {:.15}", v.lat, v.lng) = 0;
+	int *const s_vertex_num = vertex_nums(0);
+	int *const c_vertex_num = s_vertex_num + vertices.size();
+	int *const t_vertex_num = c_vertex_num + vertices.size();
+	for (size_t i = 0; i < vertices.size(); i++)
+	{	HGVertex& v = vertices[i];
 		switch (v.visibility) // fall-thru is a Good Thing!
-		{ case 2:  collapfile << *(v.unique_name) << fstr << '\n'; v.c_vertex_num[0] = cv++;
-		  case 1:  travelfile << *(v.unique_name) << fstr << '\n'; v.t_vertex_num[0] = tv++;
-		  default: simplefile << *(v.unique_name) << fstr << '\n'; v.s_vertex_num[0] = sv++;
+		{ case 2:  collapfile.write(v.tmg_line, v.tmg_len); c_vertex_num[i] = cv++;
+		  case 1:  travelfile.write(v.tmg_line, v.tmg_len); t_vertex_num[i] = tv++;
+		  default: simplefile.write(v.tmg_line, v.tmg_len); s_vertex_num[i] = sv++;
 		}
 	}
 
 	// allocate clinched_by code
 	size_t nibbles = ceil(double(TravelerList::allusers.size)/4);
-	char* cbycode = new char[nibbles+1];
+	char* cbycode = new char[nibbles];
 			// deleted after writing edges
-	cbycode[nibbles] = 0;
+	memset(cbycode, '0', nibbles);
 
 	// write edges
 	//TODO: multiple functions performing the same instructions for multiple files?
 	for (HGEdge *e = edges.begin(), *end = edges.end(); e != end; ++e)
-	{ if (e->format & HGEdge::collapsed)
-		e->collapsed_tmg_line(collapfile, fstr, 0, 0);
-	  if (e->format & HGEdge::traveled)
-	  {	for (char*n=cbycode; n<cbycode+nibbles; ++n) *n = '0';
-		e->traveled_tmg_line(travelfile, fstr, 0, 0, TravelerList::allusers.size, cbycode);
-	  }
-	  if (e->format & HGEdge::simple)
-	  {	simplefile << e->vertex1->s_vertex_num[0] << ' '
-			   << e->vertex2->s_vertex_num[0] << ' ';
-		e->segment->write_label(simplefile, 0);
-		simplefile << '\n';
+	{ if (e->format & formats & HGEdge::collapsed)
+		e->collapsed_tmg_line(collapfile, c_vertex_num, 0);
+	  if (e->format & formats & HGEdge::traveled)
+		e->traveled_tmg_line(travelfile, t_vertex_num, 0, 0, TravelerList::allusers.size, cbycode);
+	  if (e->format & formats & HGEdge::simple)
+	  {	simplefile.num(s_vertex_num[e->vertex1-vertices.data()]); simplefile.put(' ');
+		simplefile.num(s_vertex_num[e->vertex2-vertices.data()]); simplefile.put(' ');
+		simplefile.write(e->label, e->label_len);
+		simplefile.put('\n');
 	  }
 	}
 	delete[] cbycode;
 
 	// traveler names
 	for (TravelerList& t : TravelerList::allusers)
-		travelfile << t.traveler_name << ' ';
-	travelfile << '\n';
-	simplefile.close();
-	collapfile.close();
-	travelfile.close();
-	GraphListEntry* g = GraphListEntry::entries.data();
-	g[0].vertices = vertices.size(); g[0].edges = se; g[0].travelers = 0;
-	g[1].vertices = cv;		 g[1].edges = ce; g[1].travelers = 0;
-	g[2].vertices = tv;		 g[2].edges = te; g[2].travelers = TravelerList::allusers.size;
+	{	travelfile.write(t.traveler_name.data(), t.traveler_name.size());
+		travelfile.put(' ');
+	}
+	travelfile.put('\n');
 }
 
 // write a subset of the data,
@@ -427,14 +849,14 @@ void HighwayGraph::write_master_graphs_tmg()
 // by systems in the list if given,
 // or to within a given area if placeradius is given
 void HighwayGraph::write_subgraphs_tmg
-(	size_t graphnum, unsigned int threadnum, WaypointQuadtree *qt, ElapsedTime *et, std::mutex *term
+(	size_t graphnum, unsigned int threadnum, ElapsedTime *et, std::mutex *term
 )
 {	unsigned int cv_count = 0, sv_count = 0, tv_count = 0;
 	unsigned int ce_count = 0, se_count = 0, te_count = 0;
+	uint64_t s_hash = 0, c_hash = 0, t_hash = Args::tmg3; // of each format's contents
 	GraphListEntry* g = GraphListEntry::entries.data()+graphnum;
-	std::ofstream simplefile(Args::graphfilepath+'/'+g -> filename());
-	std::ofstream collapfile(Args::graphfilepath+'/'+g[1].filename());
-	std::ofstream travelfile(Args::graphfilepath+'/'+g[2].filename());
+	HGEdge::LabelMap* const labels = g->systems ? restricted_labels.at(g->systems) : 0;
+	char* const buf = tmg_buffers(threadnum);
 	TMBitset<HGVertex*, uint64_t> mv; // vertices matching all criteria
 	TMBitset<HGEdge*,   uint64_t> me; //    edges matching all criteria
 	std::vector<TravelerList*> traveler_lists;
@@ -445,75 +867,200 @@ void HighwayGraph::write_subgraphs_tmg
 	for (TravelerList *t : traveler_set)
 	{	t->traveler_num[threadnum] = travnum++;
 		traveler_lists.push_back(t);
+		t_hash = mix(t_hash ^ traveler_hash[t-TravelerList::allusers.data]);
 	}
+	g -> hash = s_hash;
+	g[1].hash = c_hash;
+	g[2].hash = t_hash;
+	g -> vertices = sv_count; g -> edges = se_count; g -> travelers = 0;
+	g[1].vertices = cv_count; g[1].edges = ce_count; g[1].travelers = 0;
+	g[2].vertices = tv_count; g[2].edges = te_count; g[2].travelers = travnum;
+	std::string report = g->tag() + fmt::format("({},{}) ({},{}) ({},{}) ",
+				sv_count, se_count, cv_count, ce_count, tv_count, te_count);
       #ifdef threading_enabled
 	term->lock();
       #endif
-	if (g->cat != g[-1].cat)
-		std::cout << '\n' << et->et() << "Writing " << g->category() << " graphs.\n";
-	std::cout << g->tag()
-		  << '(' << sv_count << ',' << se_count << ") "
-		  << '(' << cv_count << ',' << ce_count << ") "
-		  << '(' << tv_count << ',' << te_count << ") " << std::flush;
+	// report graphs in canonical order, whatever order they're written in
+	g->report.swap(report);
+	for (	GraphListEntry* r = GraphListEntry::entries.data()+GraphListEntry::reported;
+		GraphListEntry::reported < GraphListEntry::entries.size() && r->report.size();
+		GraphListEntry::reported += 3, r += 3
+	    )
+	{	if (r->cat != r[-1].cat)
+			std::cout << '\n' << et->et() << "Writing " << r->category() << " graphs.\n";
+		std::cout << r->report;
+	}
+	std::cout << std::flush;
       #ifdef threading_enabled
 	term->unlock();
       #endif
-	simplefile << "TMG 1.0 simple\n";
-	collapfile << "TMG 1.0 collapsed\n";
-	travelfile << "TMG 2.0 traveled\n";
-	simplefile << sv_count << ' ' << se_count << '\n';
-	collapfile << cv_count << ' ' << ce_count << '\n';
-	travelfile << tv_count << ' ' << te_count << ' ' << travnum << '\n';
+	if (g->regions) delete g->regions;
+	if (g->systems) delete g->systems;
+	if (g->placeradius) delete g->placeradius;
+
+	unsigned char const formats = ~unchanged(g) & 7; // to write
+	if (!formats) return;
+
+	// identical subgraphs are written once, then linked
+	auto same_counts = [&](size_t o)
+	{	// guard against hash collisions
+		GraphListEntry* const h = GraphListEntry::entries.data()+o;
+		for (size_t f = 0; f < 3; f++)
+		  if (h[f].vertices != g[f].vertices || h[f].edges != g[f].edges || h[f].travelers != g[f].travelers)
+			return false;
+		return true;
+	};
+      #ifdef threading_enabled
+	subgraph_mtx.lock();
+      #endif
+	uint64_t const hash = mix(mix(mix(s_hash) ^ c_hash) ^ t_hash);
+	auto files = subgraph_files.emplace(hash, SubgraphFiles{graphnum, 0, {}});
+	if (!files.second && same_counts(files.first->second.graphnum))
+	{	SubgraphFiles& original = files.first->second;
+		bool const written = original.written;
+		if (!written) original.duplicates.push_back(graphnum);
+	      #ifdef threading_enabled
+		subgraph_mtx.unlock();
+	      #endif
+		if (written) link_subgraph(original.graphnum, graphnum, buf);
+		return;
+	}
+      #ifdef threading_enabled
+	subgraph_mtx.unlock();
+      #endif
+
+	// files left as-is aren't opened, and their output is discarded
+	TMGWriter simplefile(buf);
+	TMGWriter collapfile(buf + TMGWriter::bufsize);
+	TMGWriter travelfile(buf + 2*TMGWriter::bufsize);
+	if (formats & HGEdge::simple)	 simplefile.open(Args::graphfilepath+'/'+g -> filename());
+	if (formats & HGEdge::collapsed) collapfile.open(Args::graphfilepath+'/'+g[1].filename());
+	if (formats & HGEdge::traveled)	 travelfile.open(Args::graphfilepath+'/'+g[2].filename());
+	simplefile.write("TMG 1.0 simple\n", 15);
+	collapfile.write("TMG 1.0 collapsed\n", 18);
+	travelfile.write(Args::tmg3 ? "TMG 3.0 traveled\n" : "TMG 2.0 traveled\n", 17);
+	simplefile.num(sv_count);	simplefile.put(' ');
+	simplefile.num(se_count);	simplefile.put('\n');
+	collapfile.num(cv_count);	collapfile.put(' ');
+	collapfile.num(ce_count);	collapfile.put('\n');
+	travelfile.num(tv_count);	travelfile.put(' ');
+	travelfile.num(te_count);	travelfile.put(' ');
+	travelfile.num(travnum);	travelfile.put('\n');
 
 	// write vertices
 	unsigned int sv = 0;
 	unsigned int cv = 0;
 	unsigned int tv = 0;
-	char fstr[57];
+	int *const s_vertex_num = vertex_nums(threadnum);
+	int *const c_vertex_num = s_vertex_num + vertices.size();
+	int *const t_vertex_num = c_vertex_num + vertices.size();
 	for (HGVertex *v : mv)
-	{	*fmt::format_to(fstr, " {:.15} {:.15}", v->lat, v->lng) = 0;
+	{	size_t const i = v-vertices.data();
 		switch(v->visibility) // fall-thru is a Good Thing!
-		{ case 2:  collapfile << *(v->unique_name) << fstr << '\n'; v->c_vertex_num[threadnum] = cv++;
-		  case 1:  travelfile << *(v->unique_name) << fstr << '\n'; v->t_vertex_num[threadnum] = tv++;
-		  default: simplefile << *(v->unique_name) << fstr << '\n'; v->s_vertex_num[threadnum] = sv++;
+		{ case 2:  collapfile.write(v->tmg_line, v->tmg_len); c_vertex_num[i] = cv++;
+		  case 1:  travelfile.write(v->tmg_line, v->tmg_len); t_vertex_num[i] = tv++;
+		  default: simplefile.write(v->tmg_line, v->tmg_len); s_vertex_num[i] = sv++;
 		}
 	}
 
 	// allocate clinched_by code
 	size_t nibbles = ceil(double(travnum)/4);
-	char* cbycode = new char[nibbles+1];
+	char* cbycode = new char[nibbles];
 			// deleted after writing edges
-	cbycode[nibbles] = 0;
+	memset(cbycode, '0', nibbles);
 
 	// write edges
 	for (HGEdge *e : me) //TODO: multiple functions performing the same instructions for multiple files?
-	{ if (e->format & HGEdge::simple)
-	  {	simplefile << e->vertex1->s_vertex_num[threadnum] << ' '
-			   << e->vertex2->s_vertex_num[threadnum] << ' ';
-		e->segment->write_label(simplefile, g->systems);
-		simplefile << '\n';
-	  }
-	  if (e->format & HGEdge::collapsed)
-		e->collapsed_tmg_line(collapfile, fstr, threadnum, g->systems);
-	  if (e->format & HGEdge::traveled)
-	  {	for (char*n=cbycode; n<cbycode+nibbles; ++n) *n = '0';
-		e->traveled_tmg_line (travelfile, fstr, threadnum, g->systems, travnum, cbycode);
+	{ if (e->format & formats & HGEdge::simple)
+	  {	simplefile.num(s_vertex_num[e->vertex1-vertices.data()]); simplefile.put(' ');
+		simplefile.num(s_vertex_num[e->vertex2-vertices.data()]); simplefile.put(' ');
+		e->write_label(simplefile, labels);
+		simplefile.put('\n');
 	  }
+	  if (e->format & formats & HGEdge::collapsed)
+		e->collapsed_tmg_line(collapfile, c_vertex_num, labels);
+	  if (e->format & formats & HGEdge::traveled)
+		e->traveled_tmg_line (travelfile, t_vertex_num, threadnum, labels, travnum, cbycode);
 	}
 	delete[] cbycode;
 
 	// traveler names
 	for (TravelerList *t : traveler_lists)
-		travelfile << t->traveler_name << ' ';
-	travelfile << '\n';
+	{	travelfile.write(t->traveler_name.data(), t->traveler_name.size());
+		travelfile.put(' ');
+	}
+	travelfile.put('\n');
 	simplefile.close();
 	collapfile.close();
 	travelfile.close();
-	if (g->regions) delete g->regions;
-	if (g->systems) delete g->systems;
-	if (g->placeradius) delete g->placeradius;
+	if (!files.second) return; // a hash collision, written independently
 
-	g -> vertices = sv_count; g -> edges = se_count; g -> travelers = 0;
-	g[1].vertices = cv_count; g[1].edges = ce_count; g[1].travelers = 0;
-	g[2].vertices = tv_count; g[2].edges = te_count; g[2].travelers = travnum;
+	// link any duplicates found while writing
+	std::vector<size_t> duplicates;
+      #ifdef threading_enabled
+	subgraph_mtx.lock();
+      #endif
+	files.first->second.written = 1;
+	duplicates.swap(files.first->second.duplicates);
+      #ifdef threading_enabled
+	subgraph_mtx.unlock();
+      #endif
+	for (size_t d : duplicates) link_subgraph(graphnum, d, buf);
+}
+
+// Each of a graph's 3 files can be left as-is if the manifest from the previous run
+// lists the same hash & counts for it, and it exists at the size listed.
+// Returns which formats can be, as a mask of HGEdge format bits.
+unsigned char HighwayGraph::unchanged(GraphListEntry* g)
+{	unsigned char same = 0;
+	if (Args::forcegraphs) return same;
+	for (size_t f = 0; f < 3; f++)
+	{	std::string const filename = g[f].filename();
+		auto m = manifest.find(filename);
+		struct stat st;
+		if (	m != manifest.end() && m->second.hash == g[f].hash
+		     && m->second.vertices == g[f].vertices && m->second.edges == g[f].edges
+		     && m->second.travelers == g[f].travelers // guard against hash collisions
+		     && !stat((Args::graphfilepath+'/'+filename).data(), &st)
+		     && size_t(st.st_size) == m->second.size // & against truncated or edited files
+		   )	same |= 1 << f;
+	}
+	return same;
+}
+
+void HighwayGraph::read_manifest()
+{	// filename;hash;vertices;edges;travelers;size
+	std::ifstream file(Args::graphfilepath+"/tmg.manifest");
+	std::string line;
+	while (getline(file, line))
+	{	char* f = &line[0];
+		char* h = strchr(f, ';');		if (!h) continue; *h++ = 0;
+		char* v = strchr(h, ';');		if (!v) continue;
+		char* e = strchr(v+1, ';');		if (!e) continue;
+		char* t = strchr(e+1, ';');		if (!t) continue;
+		char* s = strchr(t+1, ';');		if (!s) continue;
+		manifest[f] = {strtoull(h, 0, 16), (unsigned int)strtoul(v+1, 0, 10),
+			       (unsigned int)strtoul(e+1, 0, 10), (unsigned int)strtoul(t+1, 0, 10),
+			       strtoull(s+1, 0, 10)};
+	}
+}
+
+void HighwayGraph::write_manifest()
+{	// to a temporary file, renamed once complete, so an interrupted run can't leave it inconsistent
+	std::string const filename = Args::graphfilepath+"/tmg.manifest";
+	std::ofstream file(filename+".tmp");
+	struct stat st;
+	for (GraphListEntry& g : GraphListEntry::entries)
+	{	size_t size = stat((Args::graphfilepath+'/'+g.filename()).data(), &st) ? 0 : st.st_size;
+		file << fmt::format("{};{:016x};{};{};{};{}\n", g.filename(), g.hash, g.vertices, g.edges, g.travelers, size);
+	}
+	file.close();
+	rename((filename+".tmp").data(), filename.data());
+}
+
+void HighwayGraph::link_subgraph(size_t original, size_t duplicate, char* buf)
+{	// hard link (or copy) all 3 formats of an identical subgraph
+	for (size_t f = 0; f < 3; f++)
+		TMGWriter::duplicate(Args::graphfilepath+'/'+GraphListEntry::entries[original+f].filename(),
+				     Args::graphfilepath+'/'+GraphListEntry::entries[duplicate+f].filename(), buf);
 }
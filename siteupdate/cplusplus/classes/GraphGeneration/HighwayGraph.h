@@ -2,15 +2,18 @@ class ElapsedTime;
 class GraphListEntry;
 class HGEdge;
 class HGVertex;
+class HighwaySegment;
 class HighwaySystem;
 class TravelerList;
 class Waypoint;
 class WaypointQuadtree;
+#include "VertexNames.h"
 #include "../../templates/TMArray.cpp"
-#include <list>
+#include <atomic>
+#include <fstream>
+#include <map>
 #include <mutex>
 #include <unordered_map>
-#include <unordered_set>
 #include <string>
 #include <vector>
 
@@ -24,25 +27,85 @@ class HighwayGraph
       - in the simple graph
       - in the collapsed graph with hidden waypoints compressed into multi-point edges
       - in the traveled graph: collapsed edges split at endpoints of users' travels
-      - in no graph at all for temporary partially-collapsed edges created
-	during the compression process. These stick around taking up
-	space until the HighwayGraph object is destroyed. Mostly harmless.
+    Partially-collapsed edges are only tracked as spans of each chain of hidden
+    vertices while it's compressed; the edges that remain are constructed once,
+    into an exactly-sized array, with their shaping points as slices of another.
     */
 
 	public:
-	std::unordered_set<std::string> vertex_names[256];	// unique vertex labels
-	std::list<std::string> waypoint_naming_log;		// to track waypoint name compressions
-	std::mutex set_mtx[256], log_mtx;
+	// rules yielding a vertex's canonical name
+	enum : unsigned char
+	{	no_rule,	// single active/preview point; simple name, not logged
+		keep_failsafe,
+		straightforward_intersection,
+		straightforward_concurrency,
+		exit_intersection,
+		exit_number,
+		three_plus_intersection,
+		reversed_border_labels
+	};
+	struct SubgraphFiles
+	{	// the first of a set of subgraphs with identical contents
+		size_t graphnum;
+		bool written;
+		std::vector<size_t> duplicates;	// to link once written
+	};
+	struct ManifestEntry
+	{	// a graph file written by a previous run
+		uint64_t hash;
+		unsigned int vertices, edges, travelers;
+		size_t size;	// of the file as written
+	};
+	struct NameLogEntry
+	{	// how a vertex got its name, formatted when the log is written
+		Waypoint* wpt;
+		const char* taken;	// straightforward_intersection label/label name, if taken
+		const char* regional;	// canonical name with region code appended, if canonical was taken
+		uint16_t bangs;		// !s appended to regional name, if it & simple name were taken
+		unsigned char rule;
+		bool reverted;		// reverted to simple name
+	};
+
+	typedef std::vector<std::pair<uint32_t,uint32_t>> IncidenceList; // vertex & simple edge indices
+
+	VertexNames vertex_names;				// unique vertex labels
+	std::vector<std::vector<NameLogEntry>> waypoint_naming_log; // per pass & thread, to track
+								    // waypoint name compressions
+	std::mutex log_mtx;
 	std::vector<HGVertex> vertices;				// MUST be stored
 	TMArray<HGEdge> edges;					// sequentially!
+	TMArray<HGEdge*> adjacency;				// incident edge lists of all vertices
+	TMArray<HGVertex*> shaping_points;			// intermediate points of all edges
+	std::vector<std::vector<int>> vertex_num;		// per thread, vertex numbers in each format
+	std::vector<std::vector<char>> tmg_buf;			// per thread, output buffers for each format
+	std::vector<std::string> tmg_text;			// pre-formatted vertex lines, then edge coords & labels, per thread
+	std::vector<std::unordered_map<HGEdge*, std::string>> label_maps; // per distinct set of systems restricting subgraphs
+	std::unordered_map<std::vector<HighwaySystem*>*, std::unordered_map<HGEdge*, std::string>*> restricted_labels;
+								// by GraphListEntry::systems
 	unsigned int cv, tv, se, ce, te;			// vertex & edge counts
+	std::vector<uint64_t> traveler_hash;			// of traveler names
+	std::map<uint64_t, SubgraphFiles> subgraph_files;	// by hash of contents
+	std::mutex subgraph_mtx;
+	std::unordered_map<std::string, ManifestEntry> manifest; // by filename
 
 	HighwayGraph(WaypointQuadtree&, ElapsedTime&);
 
-	void namelog(std::string&&);
-	void simplify(int, std::vector<std::pair<Waypoint*,size_t>>*, unsigned int*);
+	void simplify(int, std::vector<std::pair<Waypoint*,size_t>>*, unsigned int*, std::vector<NameLogEntry>*);
+	void write_naming_log(std::ofstream&);
+	void sort_incidence(int, std::vector<HighwaySegment*>*, std::vector<IncidenceList>*);
+	void count_incidence(int, std::vector<HighwaySegment*>*, std::vector<IncidenceList>*, std::vector<HighwaySegment*>*);
+	void simple_edges(int, std::vector<HighwaySegment*>*, std::vector<IncidenceList>*);
+	void collapse(int, std::vector<HGVertex*>*, std::vector<size_t>*, std::vector<size_t>*, std::vector<uint32_t>*, std::atomic<size_t>*);
+	int* vertex_nums(unsigned int);
+	char* tmg_buffers(unsigned int);
+	void format_vertices(int);
+	void format_edges(int);
+	void restrict_labels(int, std::vector<std::vector<HighwaySystem*>>*);
 	void bitsetlogs(HGVertex*);
-	inline std::pair<std::unordered_set<std::string>::iterator,bool> vertex_name(std::string&);
+	void read_manifest();
+	void write_manifest();
+	unsigned char unchanged(GraphListEntry*);
 	void write_master_graphs_tmg();
-	void write_subgraphs_tmg(size_t, unsigned int, WaypointQuadtree*, ElapsedTime*, std::mutex*);
+	void write_subgraphs_tmg(size_t, unsigned int, ElapsedTime*, std::mutex*);
+	void link_subgraph(size_t, size_t, char*);
 };
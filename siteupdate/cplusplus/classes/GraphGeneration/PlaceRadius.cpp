@@ -3,26 +3,34 @@
 #include "HGEdge.h"
 #include "HGVertex.h"
 #include "HighwayGraph.h"
+#include "../Args/Args.h"
 #include "../Waypoint/Waypoint.h"
 #include "../WaypointQuadtree/WaypointQuadtree.h"
 #include <cmath>
 #define pi 3.141592653589793238
 
+std::vector<PlaceRadius::Trig> PlaceRadius::trig;
+std::vector<PlaceRadius*> PlaceRadius::all;
+
 PlaceRadius::PlaceRadius(const char *D, const char *T, double& Y, double& X, double& R)
 {	descr = D;
 	title = T;
 	lat = Y;
 	lng = X;
 	r = R;
+	center.setup(lat, lng);
+}
+
+void PlaceRadius::Trig::setup(double lat, double lng)
+{	// convert to radians to compute distance
+	double const rlat = lat * (pi/180);
+	sin_lat = sin(rlat);
+	cos_lat = cos(rlat);
+	rlng = lng * (pi/180);
 }
 
-bool PlaceRadius::contains_vertex(double vlat, double vlng)
-{	/* return whether coordinates are within this area */
-	// convert to radians to compute distance
-	double rlat1 = lat * (pi/180);
-	double rlng1 = lng * (pi/180);
-	double rlat2 = vlat * (pi/180);
-	double rlng2 = vlng * (pi/180);
+bool PlaceRadius::contains_vertex(Trig& v)
+{	/* return whether a vertex is within this area, its trig precomputed */
 
 	/* original formula
 	double ans = acos(cos(rlat1)*cos(rlng1)*cos(rlat2)*cos(rlng2) +\
@@ -30,7 +38,7 @@ bool PlaceRadius::contains_vertex(double vlat, double vlng)
 			  sin(rlat1)*sin(rlat2)) * 3963.1; // EARTH_RADIUS */
 
 	// spherical law of cosines formula (same as orig, with some terms factored out or removed via trig identity)
-	double ans = acos(cos(rlat1)*cos(rlat2)*cos(rlng2-rlng1)+sin(rlat1)*sin(rlat2)) * 3963.1; /* EARTH_RADIUS */
+	double ans = acos(center.cos_lat*v.cos_lat*cos(v.rlng-center.rlng)+center.sin_lat*v.sin_lat) * 3963.1; /* EARTH_RADIUS */
 
 	/* Vincenty formula
 	double ans = 
@@ -45,14 +53,13 @@ bool PlaceRadius::contains_vertex(double vlat, double vlng)
 	return ans <= r;
 }
 
-void PlaceRadius::matching_ve(TMBitset<HGVertex*,uint64_t>& mv, TMBitset<HGEdge*,uint64_t>& me, WaypointQuadtree *qt)
-{	// Compute sets of graph vertices & edges within r miles of (lat, lng).
-	// This function handles setup & sanity checks, passing control over
-	// to the recursive ve_search function to do the actual searching.
+void PlaceRadius::bounds(std::vector<Search>& searches)
+{	// Compute the span(s) of longitudes to search the quadtree within for
+	// graph vertices within r miles of (lat, lng).
 
 	// N/S sanity check: If lat is <= r/2 miles to the N or S pole, lngdelta calculation will fail.
 	// In these cases, our place radius will span the entire "width" of the world, from -180 to +180 degrees.
-	if (90-fabs(lat)*(pi/180) <= r/7926.2) return ve_search(mv, me, qt, -180, +180);
+	if (90-fabs(lat)*(pi/180) <= r/7926.2) return searches.push_back({this, -180, +180});
 
 	// width, in degrees longitude, of our bounding box for quadtree search
 	double lngdelta = acos((cos(r/3963.1) - pow(sin(lat*(pi/180)),2)) / pow(cos(lat*(pi/180)),2)) / (pi/180);
@@ -60,27 +67,59 @@ void PlaceRadius::matching_ve(TMBitset<HGVertex*,uint64_t>& mv, TMBitset<HGEdge*
 	double e_bound = lng+lngdelta;
 
 	// normal operation; search quadtree within calculated bounds
-	ve_search(mv, me, qt, w_bound, e_bound);
+	searches.push_back({this, w_bound, e_bound});
 
 	// If bounding box spans international date line to west of -180 degrees,
 	// search quadtree within the corresponding range of positive longitudes
 	if (w_bound <= -180)
 	{	do w_bound += 360; while (w_bound <= -180);
-		ve_search(mv, me, qt, w_bound, 180);
+		searches.push_back({this, w_bound, 180});
 	}
 
 	// If bounding box spans international date line to east of +180 degrees,
 	// search quadtree within the corresponding range of negative longitudes
 	if (e_bound >= 180)
 	{	do e_bound -= 360; while (e_bound >= 180);
-		ve_search(mv, me, qt, -180, e_bound);
+		searches.push_back({this, -180, e_bound});
+	}
+}
+
+void PlaceRadius::trig_thread(int t, std::vector<HGVertex>* vertices)
+{	// precompute trig for thread t's share of vertices
+	for (size_t i = t*vertices->size()/Args::numthreads, end = (t+1)*vertices->size()/Args::numthreads; i < end; i++)
+		trig[i].setup((*vertices)[i].lat, (*vertices)[i].lng);
+}
+
+void PlaceRadius::ve_thread(int t, std::vector<HGVertex>* vertices, TMArray<HGEdge>* edges, WaypointQuadtree* qt)
+{	// Compute sets of graph vertices & edges for thread t's share of areas,
+	// all in one sweep of the quadtree
+	std::vector<Search> searches;
+	for (size_t i = t; i < all.size(); i += Args::numthreads)
+	{	all[i]->vertices.alloc(vertices->data(), vertices->size());
+		all[i]->edges.alloc(edges->data, edges->size);
+		all[i]->bounds(searches);
+	}
+	if (searches.empty()) return;
+	ve_search(searches, qt, vertices->data());
+
+	// An edge is in an area if both endpoints are. Those not found in the
+	// quadtree search are tested directly, in case they're outside the bounds.
+	for (size_t i = t; i < all.size(); i += Args::numthreads)
+	{	PlaceRadius& a = *all[i];
+		for (HGVertex* v : a.vertices)
+		  for (HGEdge **e = v->incident_edges, **end = e+v->incident_count; e < end; e++)
+		  {	size_t const v2 = (v == (*e)->vertex1 ? (*e)->vertex2 : (*e)->vertex1) - vertices->data();
+			if (a.vertices[v2] || a.contains_vertex(trig[v2]))
+			  a.edges.add_value(*e);
+		  }
+		a.vertices.shrink_to_fit();
+		a.edges.shrink_to_fit();
 	}
 }
 
-void PlaceRadius::ve_search(TMBitset<HGVertex*,uint64_t>& mv, TMBitset<HGEdge*,uint64_t>& me,
-			    WaypointQuadtree *qt, double w_bound, double e_bound)
-{	// recursively search quadtree for waypoints within this PlaceRadius
-	// area, and populate a set of their corresponding graph vertices
+void PlaceRadius::ve_search(std::vector<Search>& searches, WaypointQuadtree *qt, HGVertex* v0)
+{	// recursively search quadtree for waypoints within each search's
+	// area, and populate sets of their corresponding graph vertices
 
 	// first check if this is a terminal quadrant, and if it is,
 	// we search for vertices within this quadrant
@@ -88,29 +127,31 @@ void PlaceRadius::ve_search(TMBitset<HGVertex*,uint64_t>& mv, TMBitset<HGEdge*,u
 	{	for (Waypoint *p : qt->points)
 		  if (	(!p->colocated || p == p->colocated->front())
 		  &&	p->is_or_colocated_with_active_or_preview()
-		  &&	contains_vertex(p->lat, p->lng)
 		     ){	HGVertex* v = p->vertex;
-			mv.add_value(v);
-			for (HGEdge* e : v->incident_edges)
-			{	HGVertex* v2 = v == e->vertex1 ? e->vertex2 : e->vertex1;
-				if (contains_vertex(v2->lat, v2->lng))
-				  me.add_value(e);
-			}
+			Trig& vt = trig[v-v0];
+			for (Search& s : searches)
+			  if (s.pr->contains_vertex(vt))
+			    s.pr->vertices.add_value(v);
 		      }
 	}
 	// if we're not a terminal quadrant, we need to determine which
 	// of our child quadrants we need to search and recurse into each
-	else {	//printf("DEBUG: recursive case, mid_lat=%.17g mid_lng=%.17g\n", qt->mid_lat, qt->mid_lng); fflush(stdout);
-		bool look_n = (lat + r/3963.1/(pi/180)) >= qt->mid_lat;
-		bool look_s = (lat - r/3963.1/(pi/180)) <= qt->mid_lat;
-		bool look_e = e_bound >= qt->mid_lng;
-		bool look_w = w_bound <= qt->mid_lng;
-		//std::cout << "DEBUG: recursive case, " << look_n << " " << look_s << " " << look_e << " " << look_w << std::endl;
+	else {	std::vector<Search> nw, ne, sw, se;
+		for (Search& s : searches)
+		{	bool look_n = (s.pr->lat + s.pr->r/3963.1/(pi/180)) >= qt->mid_lat;
+			bool look_s = (s.pr->lat - s.pr->r/3963.1/(pi/180)) <= qt->mid_lat;
+			bool look_e = s.e_bound >= qt->mid_lng;
+			bool look_w = s.w_bound <= qt->mid_lng;
+			if (look_n && look_w)	nw.push_back(s);
+			if (look_n && look_e)	ne.push_back(s);
+			if (look_s && look_w)	sw.push_back(s);
+			if (look_s && look_e)	se.push_back(s);
+		}
 		// now look in the appropriate child quadrants
-		if (look_n && look_w)	ve_search(mv, me, qt->nw_child, w_bound, e_bound);
-		if (look_n && look_e)	ve_search(mv, me, qt->ne_child, w_bound, e_bound);
-		if (look_s && look_w)	ve_search(mv, me, qt->sw_child, w_bound, e_bound);
-		if (look_s && look_e)	ve_search(mv, me, qt->se_child, w_bound, e_bound);
+		if (nw.size())	ve_search(nw, qt->nw_child, v0);
+		if (ne.size())	ve_search(ne, qt->ne_child, v0);
+		if (sw.size())	ve_search(sw, qt->sw_child, v0);
+		if (se.size())	ve_search(se, qt->se_child, v0);
 	     }
 }
 
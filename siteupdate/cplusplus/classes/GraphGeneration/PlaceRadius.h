@@ -3,6 +3,7 @@ class HGEdge;
 class HGVertex;
 class HighwayGraph;
 class WaypointQuadtree;
+#include "../../templates/TMArray.cpp"
 #include "../../templates/TMBitset.cpp"
 #include <iostream>
 #include <vector>
@@ -14,14 +15,33 @@ class PlaceRadius
 	*/
 
 	public:
+	struct Trig
+	{	// of a vertex or center point, for the great-circle test
+		double sin_lat, cos_lat, rlng;
+		void setup(double, double);
+	};
+	struct Search
+	{	// a span of longitudes to search the quadtree within
+		PlaceRadius* pr;
+		double w_bound, e_bound;
+	};
+
 	std::string descr;	// long description of area, E.G. "New York City"
 	std::string title;	// filename title, short name for area, E.G. "nyc"
 	double lat, lng;	// center latitude, longitude
 	double r;		// radius in miles
+	Trig center;
+	TMBitset<HGVertex*, uint64_t> vertices; // within the area
+	TMBitset<HGEdge*,   uint64_t> edges;	// with both endpoints within the area
+
+	static std::vector<Trig> trig;		// per HGVertex
+	static std::vector<PlaceRadius*> all;	// of all area & fullcustom graphs
 
 	PlaceRadius(const char *, const char *, double &, double &, double &);
 
-	bool contains_vertex(double, double);
-	void matching_ve(TMBitset<HGVertex*,uint64_t>&, TMBitset<HGEdge*,uint64_t>&, WaypointQuadtree*);
-	void   ve_search(TMBitset<HGVertex*,uint64_t>&, TMBitset<HGEdge*,uint64_t>&, WaypointQuadtree*, double, double);
+	bool contains_vertex(Trig&);
+	void bounds(std::vector<Search>&);
+	static void trig_thread(int, std::vector<HGVertex>*);
+	static void ve_thread(int, std::vector<HGVertex>*, TMArray<HGEdge>*, WaypointQuadtree*);
+	static void ve_search(std::vector<Search>&, WaypointQuadtree*, HGVertex*);
 };
@@ -0,0 +1,51 @@
+#include "TMGWriter.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+TMGWriter::TMGWriter(char* buffer): fd(-1), buf(buffer), p(buffer), end(buffer+bufsize) {}
+
+TMGWriter::TMGWriter(std::string const& filename, char* buffer): buf(buffer), p(buffer), end(buffer+bufsize)
+{	open(filename);
+}
+
+TMGWriter::~TMGWriter()
+{	close();
+}
+
+void TMGWriter::open(std::string const& filename)
+{	unlink(filename.data());
+	fd = ::open(filename.data(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+}
+
+void TMGWriter::close()
+{	flush();
+	if (fd >= 0) ::close(fd);
+	fd = -1;
+}
+
+void TMGWriter::flush()
+{	write_all(buf, p-buf);
+	p = buf;
+}
+
+void TMGWriter::write_all(const char* data, size_t n)
+{	while (fd >= 0 && n)
+	{	ssize_t const written = ::write(fd, data, n);
+		if (written >= 0) {data += written; n -= written;}
+		else if (errno != EINTR) break;
+	}
+}
+
+void TMGWriter::duplicate(std::string const& from, std::string const& to, char* buffer)
+{	// hard link to an already written file, or copy it where links aren't supported
+	unlink(to.data());
+	if (!link(from.data(), to.data())) return;
+	int in = ::open(from.data(), O_RDONLY);
+	if (in < 0) return;
+	TMGWriter out(to, buffer);
+	for (ssize_t n; (n = read(in, buffer, bufsize)) != 0;)
+	  if (n > 0) out.write_all(buffer, n);
+	  else if (errno != EINTR) break;
+	::close(in);
+}
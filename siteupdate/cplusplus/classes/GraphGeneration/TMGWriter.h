@@ -0,0 +1,50 @@
+#include <cstring>
+#include <string>
+
+class TMGWriter
+{   /* This class writes a .tmg file through a caller-supplied buffer,
+    formatting numbers by hand and flushing with large write(2) calls
+    rather than streaming each token through an ofstream.
+    Like an ofstream, a file that can't be opened silently discards output.
+    Existing files are unlinked rather than truncated, so that any
+    other names hard linked to them by duplicate() keep their contents.
+    */
+	int fd;
+	char *const buf, *p, *const end;
+
+	public:
+	static constexpr size_t bufsize = 1 << 20;
+
+	TMGWriter(char*);
+	TMGWriter(std::string const&, char*);
+	~TMGWriter();
+
+	void open(std::string const&);
+	void close();
+	void flush();
+	static void duplicate(std::string const&, std::string const&, char*);
+
+	void write(const char* s, size_t n)
+	{	if (size_t(end-p) < n)
+		{	flush();
+			if (bufsize < n) {write_all(s, n); return;}
+		}
+		memcpy(p, s, n);
+		p += n;
+	}
+
+	void put(char c)
+	{	if (p == end) flush();
+		*p++ = c;
+	}
+
+	void num(size_t n)
+	{	// in decimal
+		char d[20], *q = d+20;
+		do *--q = '0' + n%10; while (n /= 10);
+		write(q, d+20-q);
+	}
+
+	private:
+	void write_all(const char*, size_t);
+};
@@ -0,0 +1,64 @@
+#include "VertexNames.h"
+#include <cstddef>
+#include <cstring>
+
+void VertexNames::alloc(size_t names, int numthreads)
+{	// keep the table at most half full
+	size_t size = 2;
+	while (size < 2*names) size *= 2;
+	mask = size-1;
+	table = new std::atomic<const char*>[size];
+		// deleted by ~VertexNames
+	for (size_t i = 0; i < size; i++) table[i].store(0, std::memory_order_relaxed);
+	arenas.resize(numthreads);
+	for (Arena& a : arenas) a.next = a.end = 0;
+}
+
+VertexNames::~VertexNames()
+{	delete[] table;
+	for (Arena& a : arenas)
+	  for (char* b : a.blocks) delete[] b;
+}
+
+char* VertexNames::intern(std::string& n, size_t hash, int t)
+{	// copy a name & its hash into thread t's arena
+	size_t const bytes = (sizeof(size_t) + n.size() + 1 + alignof(size_t)-1) & ~(alignof(size_t)-1);
+	Arena& a = arenas[t];
+	if (a.end-a.next < ptrdiff_t(bytes))
+	{	size_t const block = bytes > 1048576 ? bytes : 1048576;
+		a.blocks.push_back(a.next = new char[block]);
+		a.end = a.next + block;
+	}
+	*(size_t*)a.next = hash;
+	char* const name = a.next + sizeof(size_t);
+	memcpy(name, n.data(), n.size()+1);
+	a.next += bytes;
+	return name;
+}
+
+std::pair<const char*,bool> VertexNames::insert(std::string& n, int t)
+{	size_t const hash = std::hash<std::string>()(n);
+	char* mine = 0;
+	for (size_t i = hash & mask;; i = (i+1) & mask)
+	{	const char* s = table[i].load(std::memory_order_acquire);
+		if (!s)
+		{	if (!mine) mine = intern(n, hash, t);
+			if (table[i].compare_exchange_strong(s, mine, std::memory_order_acq_rel))
+				return std::make_pair(mine, true);
+			// another thread claimed the slot first; s is now its name
+		}
+		if (((size_t*)s)[-1] == hash && !strcmp(s, n.data()))
+		{	// give back our unused copy, still the last thing in our arena
+			if (mine) arenas[t].next = mine - sizeof(size_t);
+			return std::make_pair(s, false);
+		}
+	}
+}
+
+const char* VertexNames::find(std::string& n)
+{	size_t const hash = std::hash<std::string>()(n);
+	for (size_t i = hash & mask;; i = (i+1) & mask)
+	{	const char* s = table[i].load(std::memory_order_acquire);
+		if (!s || ((size_t*)s)[-1] == hash && !strcmp(s, n.data())) return s;
+	}
+}
@@ -0,0 +1,32 @@
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+class VertexNames
+{   /* This class implements the set of unique vertex labels.
+
+    Open addressing on a full hash of the name, in a table allocated up front
+    with room for every vertex; empty slots are claimed by compare-and-swap,
+    so inserting & looking up names take no locks. Names are interned, each
+    preceded by its hash, in blocks owned by the inserting thread, and live
+    as long as the set does.
+    */
+	struct Arena
+	{	std::vector<char*> blocks;
+		char *next, *end;
+	};
+	std::atomic<const char*> *table;
+	size_t mask;
+	std::vector<Arena> arenas;
+
+	char* intern(std::string&, size_t, int);
+
+	public:
+	VertexNames(): table(0), mask(0) {}
+	~VertexNames();
+
+	void alloc(size_t, int);
+	std::pair<const char*,bool> insert(std::string&, int);
+	const char* find(std::string&);
+};
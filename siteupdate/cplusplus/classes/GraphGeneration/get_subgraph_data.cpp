@@ -1,13 +1,8 @@
 // Find sets of vertices & edges from the graph, optionally
 // restricted by region or system or placeradius area.
 auto pr = [&]()
-{	TMBitset<HGVertex*, uint64_t> pr_mv(vertices.data(), vertices.size());
-	TMBitset<HGEdge*,   uint64_t> pr_me(edges.data, edges.size);
-	g->placeradius->matching_ve(pr_mv, pr_me, qt);
-	pr_mv.shrink_to_fit();
-	pr_me.shrink_to_fit();
-	mv &= pr_mv;
-	me &= pr_me;
+{	mv &= g->placeradius->vertices;
+	me &= g->placeradius->edges;
 };
 if (g->regions)
      {	auto &r = *g->regions;
@@ -42,30 +37,40 @@ else if (g->systems)
      }
 else {	// We know there's a PlaceRadius, as no GraphListEntry
 	// is created for invalid fullcustom.csv data
-	mv.alloc(vertices.data(), vertices.size());
-	me.alloc(edges.data, edges.size);
-	g->placeradius->matching_ve(mv, me, qt);
-	mv.shrink_to_fit();
-	me.shrink_to_fit();
+	mv = g->placeradius->vertices;
+	me = g->placeradius->edges;
      }
 
-// count vertices
+// count & hash vertices
 for (HGVertex* v : mv)
-{	switch (v->visibility) // fall-thru is a Good Thing!
-	{	case 2:	 cv_count++;
-		case 1:	 tv_count++;
-		default: sv_count++;
+	switch (v->visibility) // fall-thru is a Good Thing!
+	{	case 2:	 cv_count++; c_hash = mix(c_hash ^ v->hash);
+		case 1:	 tv_count++; t_hash = mix(t_hash ^ v->hash);
+		default: sv_count++; s_hash = mix(s_hash ^ v->hash);
 	}
-}
 
-// count edges & create traveler set
+// count & hash edges & create traveler set
 for (HGEdge* e : me)
-{	if (e->format & HGEdge::simple)
-		se_count++;
+{	uint64_t e_hash = e->hash, et_hash = e->traveled_hash;
+	if (labels && e->mixed_systems)
+	{	HGEdge::LabelMap::iterator l = labels->find(e);
+		if (l != labels->end())
+		{	uint64_t const l_hash = hash_bytes(l->second.data(), l->second.size(), 0);
+			e_hash  = mix(e_hash  ^ l_hash);
+			et_hash = mix(et_hash ^ l_hash);
+		}
+	}
+	if (e->format & HGEdge::simple)
+	{	se_count++;
+		s_hash = mix(s_hash ^ e_hash);
+	}
 	if (e->format & HGEdge::collapsed)
-		ce_count++;
+	{	ce_count++;
+		c_hash = mix(c_hash ^ e_hash);
+	}
 	if (e->format & HGEdge::traveled)
 	{	te_count++;
+		t_hash = mix(t_hash ^ et_hash);
 		traveler_set.fast_union(e->segment->clinched_by);
 	}
 }
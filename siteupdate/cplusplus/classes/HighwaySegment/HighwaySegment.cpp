@@ -6,11 +6,11 @@
 #include "../Waypoint/Waypoint.h"
 #include "../../templates/contains.cpp"
 
-HighwaySegment::HighwaySegment(Waypoint *w, Route *rte):
+HighwaySegment::HighwaySegment(Waypoint *w, Route *rte, double l):
 	waypoint1(w-1),
 	waypoint2(w),
 	route(rte),
-	length(waypoint1->distance_to(w)),
+	length(l),
 	concurrent(0),
 	clinched_by(TravelerList::allusers.data, TravelerList::allusers.size) {}
 
@@ -43,10 +43,10 @@ void HighwaySegment::add_concurrency(std::ofstream& concurrencyfile, Waypoint* w
 		concurrencyfile << " (" << concurrent->size() << ")\n";
 	     }
 	if (route->region != other.route->region)
-	{	Datacheck::add( other.route, other.waypoint1->label, other.waypoint2->label,
-				"", "MULTI_REGION_OVERLAP", route->root );
-		Datacheck::add( route, waypoint1->label, waypoint2->label,
-				"", "MULTI_REGION_OVERLAP", other.route->root );
+	{	Datacheck::add( other.route, &other.waypoint1->label, &other.waypoint2->label,
+				0, Datacheck::MULTI_REGION_OVERLAP, route );
+		Datacheck::add( route, &waypoint1->label, &waypoint2->label,
+				0, Datacheck::MULTI_REGION_OVERLAP, other.route );
 	}
 	other.concurrent = concurrent;
 }
@@ -83,39 +83,80 @@ std::string HighwaySegment::segment_name()
 	return "";
 }//*/
 
-const char* HighwaySegment::clinchedby_code(char* code, unsigned int threadnum)
+void HighwaySegment::clinchedby_code(char* code, unsigned int travnum, unsigned int threadnum)
 {	// Compute a hexadecimal string encoding which travelers
 	// have clinched this segment, for use in "traveled" graph files.
 	// Each character stores info for traveler #n thru traveler #n+3.
 	// The first character stores traveler 0 thru traveler 3,
 	// The second character stores traveler 4 thru traveler 7, etc.
 	// For each character, the low-order bit stores traveler n, and the high bit traveler n+3.
+	// code must be all '0's beforehand; only this segment's travelers'
+	// characters are set, and clear_code sets them back to '0'.
+
+	static const char hex[] = "0123456789ABCDEF";
+	if (travnum == TravelerList::allusers.size)
+	{	// traveler numbers are clinched_by indices;
+		// expand each nonzero unit into 8 characters
+		size_t const nibbles = (travnum+3)/4;
+		for (size_t u = 0, units = clinched_by.num_units(); u < units; u++)
+		  if (uint32_t bits = clinched_by.get_unit(u))
+		    for (char *c = code+8*u, *end = code + (8*u+8 < nibbles ? 8*u+8 : nibbles); c < end; c++, bits >>= 4)
+			*c = hex[bits & 15];
+		return;
+	}
+	for (TravelerList* t : clinched_by)
+		code[t->traveler_num[threadnum]/4] |= 1 << t->traveler_num[threadnum]%4;
+	for (TravelerList* t : clinched_by)
+	{	char& c = code[t->traveler_num[threadnum]/4];
+		if (c > '9' && c < 'A') c += 7;
+	}
+}
 
+void HighwaySegment::clear_code(char* code, unsigned int travnum, unsigned int threadnum)
+{	// undo clinchedby_code
+	if (travnum == TravelerList::allusers.size)
+	{	size_t const nibbles = (travnum+3)/4;
+		for (size_t u = 0, units = clinched_by.num_units(); u < units; u++)
+		  if (clinched_by.get_unit(u))
+		    for (char *c = code+8*u, *end = code + (8*u+8 < nibbles ? 8*u+8 : nibbles); c < end; c++)
+			*c = '0';
+		return;
+	}
 	for (TravelerList* t : clinched_by)
-		code[t->traveler_num[threadnum]/4] += 1 << t->traveler_num[threadnum]%4;
-	for (char* nibble = code; *nibble; ++nibble) if (*nibble > '9') *nibble += 7;
-	return code;
+		code[t->traveler_num[threadnum]/4] = '0';
 }
 
-// compute an edge label, optionally restricted by systems
-void HighwaySegment::write_label(std::ofstream& file, std::vector<HighwaySystem*> *systems)
+// append an edge label, optionally restricted by systems
+void HighwaySegment::append_label(std::string& label, std::vector<HighwaySystem*> *systems)
 {	if (concurrent)
 	     {	bool write_comma = 0;
 		for (HighwaySegment* cs : *concurrent)
 		  if ( !cs->route->system->devel() && (!systems || contains(*systems, cs->route->system)) )
-		  {	if  (write_comma) file << ',';
+		  {	if  (write_comma) label += ',';
 			else write_comma = 1;
-			file << cs->route->route;
-			file << cs->route->banner;
-			file << cs->route->abbrev;
+			label += cs->route->route;
+			label += cs->route->banner;
+			label += cs->route->abbrev;
 		  }
 	     }
-	else {	file << route->route;
-		file << route->banner;
-		file << route->abbrev;
+	else {	label += route->route;
+		label += route->banner;
+		label += route->abbrev;
 	     }
 }
 
+// is this segment concurrent with non-devel routes in more than one system?
+bool HighwaySegment::mixed_systems()
+{	if (!concurrent) return 0;
+	HighwaySystem* h = 0;
+	for (HighwaySegment* cs : *concurrent)
+	  if (!cs->route->system->devel())
+	  {	if (!h) h = cs->route->system;
+		else if (h != cs->route->system) return 1;
+	  }
+	return 0;
+}
+
 // find canonical segment for HGEdge construction, just in case a devel system is listed earlier in systems.csv
 HighwaySegment* HighwaySegment::canonical_edge_segment()
 {	if (!concurrent) return this;
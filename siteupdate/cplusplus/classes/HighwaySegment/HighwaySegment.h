@@ -21,7 +21,7 @@ class HighwaySegment
 
 	class iterator;
 
-	HighwaySegment(Waypoint*, Route*);
+	HighwaySegment(Waypoint*, Route*, double);
 	~HighwaySegment();
 
 	std::string str();
@@ -30,8 +30,10 @@ class HighwaySegment
 
 	// graph generation functions
 	std::string segment_name();
-	const char* clinchedby_code(char*, unsigned int);
-	void write_label(std::ofstream&, std::vector<HighwaySystem*> *);
+	void clinchedby_code(char*, unsigned int, unsigned int);
+	void clear_code(char*, unsigned int, unsigned int);
+	void append_label(std::string&, std::vector<HighwaySystem*> *);
+	bool mixed_systems();
 	HighwaySegment* canonical_edge_segment();
 	bool same_ap_routes(HighwaySegment*);
 	bool same_vis_routes(HighwaySegment*);
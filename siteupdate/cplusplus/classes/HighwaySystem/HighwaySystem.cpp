@@ -12,6 +12,7 @@
 #include "../TravelerList/TravelerList.h"
 #include "../Waypoint/Waypoint.h"
 #include "../../functions/tmstring.h"
+#include <algorithm>
 #include <fmt/format.h>
 #include <fstream>
 
@@ -140,6 +141,31 @@ void HighwaySystem::systems_csv(ErrorList& el)
 	file.close();
 }
 
+void HighwaySystem::edge_thread(std::mutex* mtx, HighwaySegment** canonical, std::vector<size_t>* sys_offset)
+{	// without a canonical segment array, count each system's canonical segments;
+	// with one, list them at each system's offset into it
+	while (it != syslist.end())
+	{	for (mtx->lock(); it != syslist.end(); it++)
+		  if (it->active_or_preview()) break;
+		if (it == syslist.end()) return mtx->unlock();
+		HighwaySystem& h = *it++;
+		mtx->unlock();
+
+		size_t& offset = (*sys_offset)[&h-syslist.data];
+		if (canonical)
+		{	HighwaySegment** c = canonical + offset;
+			for (Route& r : h.routes)
+			  for (HighwaySegment& s : r.segments)
+			    if (&s == s.canonical_edge_segment())
+			      *c++ = &s;
+		}
+		else	for (Route& r : h.routes)
+			  for (HighwaySegment& s : r.segments)
+			    if (&s == s.canonical_edge_segment())
+			      offset++;
+	}
+}
+
 void HighwaySystem::ve_thread(std::mutex* mtx, std::vector<HGVertex>* vertices, TMArray<HGEdge>* edges)
 {	while (it != syslist.end())
 	{	for (mtx->lock(); it != syslist.end(); it++)
@@ -154,16 +180,16 @@ void HighwaySystem::ve_thread(std::mutex* mtx, std::vector<HGVertex>* vertices,
 		  for (Waypoint& w : r.points)
 		  { HGVertex* v = w.hashpoint()->vertex;
 		    if (h.vertices.add_value(v))
-		      for (HGEdge* e : v->incident_edges)
-			if (e->segment->concurrent)
-			{ for (HighwaySegment* s : *e->segment->concurrent)
+		      for (HGEdge **e = v->incident_edges, **end = e+v->incident_count; e < end; e++)
+			if ((*e)->segment->concurrent)
+			{ for (HighwaySegment* s : *(*e)->segment->concurrent)
 			    if (s->route->system == &h)
-			    {	h.edges.add_value(e);
+			    {	h.edges.add_value(*e);
 				break;
 			    }
 			}
-			else if (e->segment->route->system == &h)
-				h.edges.add_value(e);
+			else if ((*e)->segment->route->system == &h)
+				h.edges.add_value(*e);
 		  }
 		h.vertices.shrink_to_fit();
 		h.edges.shrink_to_fit();
@@ -207,38 +233,45 @@ std::string HighwaySystem::level_name()
 	}
 }
 
+void HighwaySystem::list_travelers()
+{	// one pass over all travelers' system mileages, so that
+	// stats_csv need only visit those with mileage in each system
+	for (TravelerList& t : TravelerList::allusers)
+	  for (auto& srm : t.system_region_mileages)
+	    srm.first->travelers.push_back(&t);
+}
+
 void HighwaySystem::stats_csv()
 {	if (!active_or_preview()) return;
 	std::ofstream sysfile(Args::csvstatfilepath + "/" + systemname + "-all.csv");
 	sysfile << "Traveler,Total";
-	std::list<Region*> regions;
-	double total_mi = 0;
 	char fstr[112];
-	for (std::pair<Region* const, double>& rm : mileage_by_region)
-	{	regions.push_back(rm.first);
-		total_mi += rm.second;
-	}
-	regions.sort();
 	for (Region *region : regions)
 		sysfile << ',' << region->code;
 	sysfile << '\n';
-	for (TravelerList& t : TravelerList::allusers)
-	{	// only include entries for travelers who have any mileage in system
-		auto srm_it = t.system_region_mileages.find(this);
-		if (srm_it != t.system_region_mileages.end())
-		{	*fmt::format_to(fstr, ",{:.2f}", t.system_miles(this)) = 0;
-			sysfile << t.traveler_name << fstr;
-			for (Region *region : regions)
-			{	auto trm_it = srm_it->second.find(region);
-				if (trm_it != srm_it->second.end())
-				{	*fmt::format_to(fstr, ",{:.2f}", trm_it->second) = 0;
-					sysfile << fstr;
-				}
-				else	sysfile << ",0";
-			}
-			sysfile << '\n';
+	// a dense row of each traveler's mileage by region, -1 where there's no entry
+	std::vector<double> row(regions.size());
+	for (TravelerList* t : travelers)
+	{	double t_system_miles = 0;
+		std::fill(row.begin(), row.end(), -1);
+		for (std::pair<Region* const, double>& rm : t->system_region_mileages.at(this))
+		{	auto it = std::lower_bound(regions.begin(), regions.end(), rm.first);
+			if (it != regions.end() && *it == rm.first)
+				row[it - regions.begin()] = rm.second;
+			t_system_miles += rm.second;
+		}
+		*fmt::format_to(fstr, ",{:.2f}", t_system_miles) = 0;
+		sysfile << t->traveler_name << fstr;
+		for (double mi : row)
+		{	if (mi < 0)
+				sysfile << ",0";
+			else {	*fmt::format_to(fstr, ",{:.2f}", mi) = 0;
+				sysfile << fstr;
+			     }
 		}
+		sysfile << '\n';
 	}
+	std::vector<TravelerList*>().swap(travelers);
 	*fmt::format_to(fstr, "TOTAL,{:.2f}", total_mileage()) = 0;
 	sysfile << fstr;
 	for (Region *region : regions)
@@ -2,8 +2,10 @@ class ConnectedRoute;
 class ErrorList;
 class HGEdge;
 class HGVertex;
+class HighwaySegment;
 class Region;
 class Route;
+class TravelerList;
 #include "../../templates/TMArray.cpp"
 #include "../../templates/TMBitset.cpp"
 #include <mutex>
@@ -42,6 +44,8 @@ class HighwaySystem
 	TMBitset<HGVertex*, uint64_t> vertices;
 	TMBitset<HGEdge*,   uint64_t> edges;
 	std::unordered_map<Region*, double> mileage_by_region;
+	std::vector<Region*> regions;		// keys of mileage_by_region, sorted once for all reports
+	std::vector<TravelerList*> travelers;	// with mileage in this system, in allusers order
 	std::unordered_set<std::string>listnamesinuse, unusedaltroutenames;
 	std::mutex mtx;
 
@@ -65,5 +69,7 @@ class HighwaySystem
 	void mark_routes_in_use(std::string&, std::string&);
 
 	static void systems_csv(ErrorList&);
+	static void list_travelers();
+	static void edge_thread(std::mutex*, HighwaySegment**, std::vector<size_t>*);
 	static void ve_thread(std::mutex* mtx, std::vector<HGVertex>*, TMArray<HGEdge>*);
 };
@@ -15,9 +15,9 @@ void HighwaySystem::route_integrity(ErrorList& el)
 		#define CSV_LINE r.system->systemname + ".csv#L" + std::to_string(r.index()+2)
 		if (r.abbrev.empty())
 		{	if ( r.banner.size() && !strncmp(r.banner.data(), r.city.data(), r.banner.size()) )
-			  Datacheck::add(&r, "", "", "", "ABBREV_AS_CHOP_BANNER", CSV_LINE);
+			  Datacheck::add(&r, 0, 0, 0, Datacheck::ABBREV_AS_CHOP_BANNER, CSV_LINE);
 		} else	if (r.city.empty())
-			  Datacheck::add(&r, "", "", "", "ABBREV_NO_CITY", CSV_LINE);
+			  Datacheck::add(&r, 0, 0, 0, Datacheck::ABBREV_NO_CITY, CSV_LINE);
 		#undef CSV_LINE
 
 		// per-waypoint colocation-based datachecks
@@ -28,7 +28,7 @@ void HighwaySystem::route_integrity(ErrorList& el)
 				if (w.colocated && &w == w.colocated->front())
 				  for (auto p = ++w.colocated->begin(), end = w.colocated->end(); p != end; p++)
 				    if ((*p)->is_hidden)
-				    {	Datacheck::add(w.route, w.label, "", "", "VISIBLE_HIDDEN_COLOC", (*p)->root_at_label());
+				    {	Datacheck::add(w.route, &w.label, 0, 0, Datacheck::VISIBLE_HIDDEN_COLOC, *p);
 					break;
 				    }
 			}	// "hidden front" flavored VHC is handled via Waypoint::hidden_junction below
@@ -85,9 +85,9 @@ void Region::ve_thread(std::mutex* mtx, std::vector<HGVertex>* vertices, TMArray
 		    for (Waypoint& w : r->points)
 		    { HGVertex* v = w.hashpoint()->vertex;
 		      if (rg.vertices.add_value(v))
-			for (HGEdge* e : v->incident_edges)
-			  if (e->segment->route->region == &rg)
-			    rg.edges.add_value(e);
+			for (HGEdge **e = v->incident_edges, **end = e+v->incident_count; e < end; e++)
+			  if ((*e)->segment->route->region == &rg)
+			    rg.edges.add_value(*e);
 		    }
 		rg.vertices.shrink_to_fit();
 		rg.edges.shrink_to_fit();
@@ -10,6 +10,8 @@
 #include "../Region/Region.h"
 #include "../Waypoint/Waypoint.h"
 #include "../../functions/tmstring.h"
+#include <algorithm>
+#include <cstring>
 #include <fmt/format.h>
 #include <sys/stat.h>
 
@@ -154,6 +156,48 @@ std::string Route::name_no_abbrev()
 	return route + banner;
 }
 
+void Route::append_list_entry_name(std::string& name)
+{	// list_entry_name without a temporary string
+	name += route;
+	name += banner;
+	name += abbrev;
+}
+
+static bool same_concat(const std::string* const* a, const std::string* const* b)
+{	// do the null-terminated lists of strings a & b concatenate to the same string?
+	// Their total lengths must already be known to match.
+	size_t i = 0, j = 0;
+	while (*a && *b)
+	{	size_t const n = std::min((*a)->size()-i, (*b)->size()-j);
+		if (memcmp((*a)->data()+i, (*b)->data()+j, n)) return 0;
+		if ((i += n) == (*a)->size()) {a++; i = 0;}
+		if ((j += n) == (*b)->size()) {b++; j = 0;}
+	}
+	return 1;
+}
+
+bool Route::same_list_entry_name(Route* r)
+{	// list_entry_name() == r->list_entry_name() without the temporary strings
+	const std::string* const a[] = {&route, &banner, &abbrev, 0};
+	const std::string* const b[] = {&r->route, &r->banner, &r->abbrev, 0};
+	return route.size() + banner.size() + abbrev.size() == r->route.size() + r->banner.size() + r->abbrev.size()
+	    && same_concat(a, b);
+}
+
+bool Route::same_no_abbrev_name(Route* r)
+{	// name_no_abbrev() == r->name_no_abbrev() without the temporary strings
+	const std::string* const a[] = {&route, &banner, 0};
+	const std::string* const b[] = {&r->route, &r->banner, 0};
+	return route.size() + banner.size() == r->route.size() + r->banner.size()
+	    && same_concat(a, b);
+}
+
+bool Route::no_abbrev_begins(const char* label)
+{	// does label begin with name_no_abbrev()?
+	return !strncmp(label, route.data(), route.size())
+	    && !strncmp(label+route.size(), banner.data(), banner.size());
+}
+
 double Route::clinched_by_traveler_index(size_t t)
 {	double miles = 0;
 	for (HighwaySegment& s : segments)
@@ -238,17 +282,28 @@ bool Route::is_disconnected()
 {	return bools & 2;
 }
 
+bool Route::in_scope()
+{	return !(bools & 4);
+}
+
+bool Route::out_of_scope(std::string const& root)
+{	// whether root names a Route outside the datacheck scope
+	if (Args::scope.empty()) return 0;
+	auto r = root_hash.find(root);
+	return r != root_hash.end() && !r->second->in_scope();
+}
+
 // datacheck
 void Route::con_mismatch()
 {	if (route != con_route->route)
-		Datacheck::add(this, "", "", "", "CON_ROUTE_MISMATCH",
+		Datacheck::add(this, 0, 0, 0, Datacheck::CON_ROUTE_MISMATCH,
 			       route+" <-> "+con_route->route);
 	if (banner != con_route->banner)
 	  if (abbrev.size() && abbrev == con_route->banner)
-		Datacheck::add(this, "", "", "", "ABBREV_AS_CON_BANNER", system->systemname + "," +
+		Datacheck::add(this, 0, 0, 0, Datacheck::ABBREV_AS_CON_BANNER, system->systemname + "," +
 			       std::to_string(index()+2) + ',' + 
 			       std::to_string(con_route->index()+2));
-	  else	Datacheck::add(this, "", "", "", "CON_BANNER_MISMATCH",
+	  else	Datacheck::add(this, 0, 0, 0, Datacheck::CON_BANNER_MISMATCH,
 			       (banner.size() ? banner : "(blank)") + " <-> " +
 			       (con_route->banner.size() ? con_route->banner : "(blank)"));
 }
@@ -274,11 +329,11 @@ void Route::create_label_hashes()
 		upper(upper_label.data());
 		// if primary label not duplicated, add to pri_label_hash
 		if (alt_label_hash.count(upper_label))
-		{	Datacheck::add(this, points[index].label, "", "", "DUPLICATE_LABEL", "");
+		{	Datacheck::add(this, &points[index].label, 0, 0, Datacheck::DUPLICATE_LABEL);
 			duplicate_labels.insert(upper_label);
 		}
 		else if (!pri_label_hash.emplace(upper_label, index).second)
-		{	Datacheck::add(this, points[index].label, "", "", "DUPLICATE_LABEL", "");
+		{	Datacheck::add(this, &points[index].label, 0, 0, Datacheck::DUPLICATE_LABEL);
 			duplicate_labels.insert(upper_label);
 		}
 		for (std::string& a : points[index].alt_labels)
@@ -290,11 +345,11 @@ void Route::create_label_hashes()
 			// create label->index hashes and check if AltLabels duplicated
 			auto A = pri_label_hash.find(a);
 			if (A != pri_label_hash.end())
-			{	Datacheck::add(this, points[A->second].label, "", "", "DUPLICATE_LABEL", "");
+			{	Datacheck::add(this, &points[A->second].label, 0, 0, Datacheck::DUPLICATE_LABEL);
 				duplicate_labels.insert(a);
 			}
 			else if (!alt_label_hash.emplace(a, index).second)
-			{	Datacheck::add(this, a, "", "", "DUPLICATE_LABEL", "");
+			{	Datacheck::add(this, Datacheck::keep(std::string(a)), 0, 0, Datacheck::DUPLICATE_LABEL);
 				duplicate_labels.insert(a);
 			}
 		}
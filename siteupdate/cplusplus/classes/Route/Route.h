@@ -75,6 +75,9 @@ class Route
 	char bools; // bitmask
 	  // &1 is_reversed
 	  // &2 disconnected
+	  // &4 outside datacheck scope
+	  // &8 .wpt not to be read
+	  // &16 .wpt read
 
 	static std::unordered_map<std::string, Route*> root_hash, pri_list_hash, alt_list_hash;
 	static std::unordered_set<std::string>	all_wpt_files;
@@ -89,10 +92,14 @@ class Route
 	std::string readable_name();
 	std::string list_entry_name();
 	std::string name_no_abbrev();
+	void append_list_entry_name(std::string&);
+	bool same_list_entry_name(Route*);
+	bool same_no_abbrev_name(Route*);
+	bool no_abbrev_begins(const char*);
 	double clinched_by_traveler_index(size_t);
 	//std::string list_line(int, int);
 	void write_nmp_merged();
-	void store_traveled_segments(TravelerList*, std::ofstream&, std::string&, unsigned int, unsigned int);
+	void store_traveled_segments(TravelerList*, std::ostream&, std::string&, unsigned int, unsigned int);
 	void mark_label_in_use(std::string&);
 	void mark_labels_in_use(std::string&, std::string&);
 	void create_label_hashes();
@@ -104,5 +111,8 @@ class Route
 	bool is_reversed();
 	void set_disconnected();
 	bool is_disconnected();
+	bool in_scope();
+	static bool out_of_scope(std::string const&);
+	void scan_wpt(WaypointQuadtree *);
 };
 bool sort_route_updates_oldest(const Route*, const Route*);
@@ -1,4 +1,3 @@
-#define FMT_HEADER_ONLY
 #include "Route.h"
 #include "../Args/Args.h"
 #include "../Datacheck/Datacheck.h"
@@ -7,7 +6,6 @@
 #include "../HighwaySystem/HighwaySystem.h"
 #include "../Waypoint/Waypoint.h"
 #include "../WaypointQuadtree/WaypointQuadtree.h"
-#include <fmt/format.h>
 
 void Route::read_wpt(WaypointQuadtree *all_waypoints, ErrorList *el, bool usa_flag)
 {	/* read data into the Route's waypoint list from a .wpt file */
@@ -19,6 +17,8 @@ void Route::read_wpt(WaypointQuadtree *all_waypoints, ErrorList *el, bool usa_fl
 	awf_mtx.lock();
 	all_wpt_files.erase(filename);
 	awf_mtx.unlock();
+	if (bools & 24) return;	// outside a datacheck scope, or already read
+	bools |= 16;
 
 	// read .wpt file into memory
 	std::ifstream file(filename);
@@ -48,7 +48,7 @@ void Route::read_wpt(WaypointQuadtree *all_waypoints, ErrorList *el, bool usa_fl
 	// process lines
 	const size_t linecount = lines.size();
 	Waypoint *w = points.alloc(linecount);
-	HighwaySegment* s = segments.alloc(linecount ? linecount-1 : 0); // cope with zero-waypoint files: all blank lines, not even any whitespace
+	segments.alloc(linecount ? linecount-1 : 0); // cope with zero-waypoint files: all blank lines, not even any whitespace
 	lines.push_back(wptdata+wptdatasize+1);	// add a dummy "past-the-end" element to make l[1]-2 work
 	for (char **l = lines.data(), **dummy = l+linecount; l < dummy; l++)
 	{	// strip whitespace from beginning...
@@ -72,23 +72,8 @@ void Route::read_wpt(WaypointQuadtree *all_waypoints, ErrorList *el, bool usa_fl
 
 		all_waypoints->insert(w, 1);
 
-		// single-point Datachecks, and HighwaySegment
+		// single-point Datachecks
 		w->out_of_bounds();
-		if (w > points.data)
-		{	// add HighwaySegment, if not first point
-			new(s) HighwaySegment(w, this);
-			// placement new
-			// visible distance update, and last segment length check
-			double last_distance = s->length;
-			vis_dist += last_distance;
-			if (last_distance > 20)
-			  Datacheck::add(this, w[-1].label, w->label, "", "LONG_SEGMENT", fmt::format("{:.2f}", last_distance));
-			s++;
-		}
-		else if (w->is_hidden) // look for hidden beginning
-		     {	Datacheck::add(this, w->label, "", "", "HIDDEN_TERMINUS", "");
-			last_visible = w;
-		     }
 		// checks for visible points
 		if (!w->is_hidden)
 		{	const char *slash = strchr(w->label.data(), '/');
@@ -104,17 +89,38 @@ void Route::read_wpt(WaypointQuadtree *all_waypoints, ErrorList *el, bool usa_fl
 			w->label_slashes(slash);
 			w->lacks_generic();
 			w->underscore_datachecks(slash);
-			w->visible_distance(vis_dist, last_visible);
 		}
 		++w;
 	}
 	delete[] wptdata;
 
+	// HighwaySegments, with lengths from trig precomputed once per waypoint
+	Waypoint::Trig trig(points.data, points.size);
+	HighwaySegment* s = segments.data;
+	for (Waypoint* w = points.data; w < points.end(); w++)
+	{	if (w > points.data)
+		{	// add HighwaySegment, if not first point
+			new(s) HighwaySegment(w, this, trig.distance(w-points.data));
+			// placement new
+			// visible distance update, and last segment length check
+			double last_distance = s->length;
+			vis_dist += last_distance;
+			if (last_distance > 20)
+			  Datacheck::add(this, &w[-1].label, &w->label, 0, Datacheck::LONG_SEGMENT, last_distance);
+			s++;
+		}
+		else if (w->is_hidden) // look for hidden beginning
+		     {	Datacheck::add(this, &w->label, 0, 0, Datacheck::HIDDEN_TERMINUS);
+			last_visible = w;
+		     }
+		if (!w->is_hidden) w->visible_distance(vis_dist, last_visible);
+	}
+
 	// per-route datachecks
 	if (points.size < 2) el->add_error("Route contains fewer than 2 points: " + str());
 	else {	// look for hidden endpoint
 		if (points.back().is_hidden)
-		{	Datacheck::add(this, points.back().label, "", "", "HIDDEN_TERMINUS", "");
+		{	Datacheck::add(this, &points.back().label, 0, 0, Datacheck::HIDDEN_TERMINUS);
 			// do one last check in case a VISIBLE_DISTANCE error coexists
 			// here, as this was only checked earlier for visible points
 			points.back().visible_distance(vis_dist, last_visible);
@@ -123,10 +129,10 @@ void Route::read_wpt(WaypointQuadtree *all_waypoints, ErrorList *el, bool usa_fl
 		for (Waypoint* p = points.data+1; p < points.end()-1; p++)
 		{	//cout << "computing angle for " << p[-1].str() << ' ' << p->str() << ' ' << p[1].str() << endl;
 			if (p[-1].same_coords(p) || p[1].same_coords(p))
-				Datacheck::add(this, p[-1].label, p->label, p[1].label, "BAD_ANGLE", "");
-			else {	double angle = p->angle();
+				Datacheck::add(this, &p[-1].label, &p->label, &p[1].label, Datacheck::BAD_ANGLE);
+			else {	double angle = trig.angle(p-points.data);
 				if (angle > 135)
-				  Datacheck::add(this, p[-1].label, p->label, p[1].label, "SHARP_ANGLE", fmt::format("{:.2f}", angle));
+				  Datacheck::add(this, &p[-1].label, &p->label, &p[1].label, Datacheck::SHARP_ANGLE, angle);
 			     }
 		}
 	     }
@@ -134,3 +140,20 @@ void Route::read_wpt(WaypointQuadtree *all_waypoints, ErrorList *el, bool usa_fl
 	//std::cout << str() << std::flush;
 	//print_route();
 }
+
+void Route::scan_wpt(WaypointQuadtree *all_waypoints)
+{	/* for a Route left unread outside a datacheck scope, see whether any
+	coordinates in its .wpt file are colocated with or within the near-miss
+	tolerance of a Waypoint read, and if so, have it read next */
+	if ((bools & 24) != 8) return;
+	std::ifstream file(Args::datapath + "/data/" + rg_str + "/" + system->systemname + "/" + root + ".wpt");
+	std::string line;
+	while (getline(file, line))
+	{	const char* lat = strstr(line.data(), "lat=");
+		const char* lon = strstr(line.data(), "lon=");
+		if (lat && lon && all_waypoints->any_near(atof(lat+4), atof(lon+4), Args::nmpthreshold))
+		{	bools &= ~8;
+			return;
+		}
+	}
+}
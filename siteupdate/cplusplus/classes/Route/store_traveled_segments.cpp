@@ -4,7 +4,7 @@
 #include "../TravelerList/TravelerList.h"
 #include <fstream>
 
-void Route::store_traveled_segments(TravelerList* t, std::ofstream& log, std::string& update, unsigned int beg, unsigned int endex)
+void Route::store_traveled_segments(TravelerList* t, std::ostream& log, std::string& update, unsigned int beg, unsigned int endex)
 {	// store clinched segments with traveler and traveler with segments
 	size_t index = t-TravelerList::allusers.data;
 	for (HighwaySegment *hs = segments.data+beg, *end = segments.data+endex; hs < end; hs++)
@@ -11,6 +11,7 @@
 #include "../../functions/tmstring.h"
 #include "../../templates/contains.cpp"
 #include <dirent.h>
+#include <sstream>
 
 TravelerList::TravelerList(std::string& travname, ErrorList* el)
 {	// initialize object variables
@@ -27,8 +28,8 @@ TravelerList::TravelerList(std::string& travname, ErrorList* el)
 	std::string update;
 	if (Args::splitregionpath != "") splist.open(Args::splitregionpath+"/list_files/"+travname);
 
-	// init user log
-	std::ofstream log(Args::logfilepath+"/users/"+traveler_name+".log");
+	// init user log, kept in memory until stats are added by userlog
+	std::ostringstream log;
 	time_t StartTime = time(0);
 	log << "Log file created at: ";
 	mtx.lock();
@@ -158,7 +159,7 @@ TravelerList::TravelerList(std::string& travname, ErrorList* el)
 	}
 	delete[] listdata;
 	log << "Processed " << list_entries << " good lines marking " << clinched_segments.size() << " segments traveled.\n";
-	log.close();
+	log_head = log.str();
 	splist.close();
 }
 
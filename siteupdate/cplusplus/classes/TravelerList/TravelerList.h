@@ -33,6 +33,7 @@ class TravelerList
 	public:
 	std::vector<HighwaySegment*> clinched_segments;
 	std::string traveler_name;
+	std::string log_head;	// user log lines from reading the .list file, held until userlog writes the file
 	std::unordered_map<Region*, double> active_preview_mileage_by_region;				// total mileage per region, active+preview only
 	std::unordered_map<Region*, double> active_only_mileage_by_region;				// total mileage per region, active only
 	std::unordered_map<HighwaySystem*, std::unordered_map<Region*, double>> system_region_mileages;	// mileage per region per system
@@ -6,22 +6,25 @@
 #include "../Region/Region.h"
 #include "../Route/Route.h"
 #include "../../functions/tmstring.h"
+#include <algorithm>
 #include <fmt/format.h>
 #include <fstream>
+#include <sstream>
 
 void TravelerList::userlog(const double total_active_only_miles, const double total_active_preview_miles)
 {	char fstr[112];
 	std::cout << "." << std::flush;
-	std::ofstream log(Args::logfilepath+"/users/"+traveler_name+".log", std::ios::app);
+	std::ostringstream log;
 	log << "Clinched Highway Statistics\n";
 	log << "Overall in active systems: " << format_clinched_mi(fstr, active_only_miles(), total_active_only_miles) << '\n';
 	log << "Overall in active+preview systems: " << format_clinched_mi(fstr, active_preview_miles(), total_active_preview_miles) << '\n';
 
 	log << "Overall by region: (each line reports active only then active+preview)\n";
-	std::list<Region*> travregions;
+	std::vector<Region*> travregions;
+	travregions.reserve(active_preview_mileage_by_region.size());
 	for (std::pair<Region* const, double> &rm : active_preview_mileage_by_region)
 		travregions.push_back(rm.first);
-	travregions.sort();
+	std::sort(travregions.begin(), travregions.end());
 	for (Region *region : travregions)
 	{	double t_active_miles = 0;
 		if (active_only_mileage_by_region.count(region))
@@ -38,7 +41,8 @@ void TravelerList::userlog(const double total_active_only_miles, const double to
 	// stats by system
 	for (HighwaySystem *h = HighwaySystem::syslist.data, *end = HighwaySystem::syslist.end(); h != end; h++)
 	  if (h->active_or_preview())
-	  {	if (system_region_mileages.count(h))
+	  {	auto srm_it = system_region_mileages.find(h);
+		if (srm_it != system_region_mileages.end())
 		{	double t_system_overall = system_miles(h);
 			if (h->active())
 				active_systems_traveled++;
@@ -52,14 +56,10 @@ void TravelerList::userlog(const double total_active_only_miles, const double to
 			    << format_clinched_mi(fstr, t_system_overall, h->total_mileage()) << '\n';
 			if (sysmbr.size() > 1)
 			{	log << "System " << h->systemname << " by region:\n";
-				std::list<Region*> sysregions;
-				for (std::pair<Region* const, double> &rm : sysmbr)
-					sysregions.push_back(rm.first);
-				sysregions.sort();
-				for (Region *region : sysregions)
+				for (Region *region : h->regions)
 				{	double system_region_mileage = 0;
-					auto it = system_region_mileages.at(h).find(region);
-					if (it != system_region_mileages.at(h).end())
+					auto it = srm_it->second.find(region);
+					if (it != srm_it->second.end())
 						system_region_mileage = it->second;
 					log << "  " << region->code << ": " << format_clinched_mi(fstr, system_region_mileage, sysmbr.at(region)) << '\n';
 				}
@@ -128,5 +128,11 @@ void TravelerList::userlog(const double total_active_only_miles, const double to
 	    log	<< r->last_update[0] << " | " << r->last_update[1] << " | " << r->last_update[2] << " | "
 		<< r->last_update[3] << " | " << r->last_update[4] << '\n';
 
-	log.close();
+	// write the whole file at once
+	std::string stats = log.str();
+	std::ofstream file(Args::logfilepath+"/users/"+traveler_name+".log");
+	file.write(log_head.data(), log_head.size());
+	file.write(stats.data(), stats.size());
+	file.close();
+	std::string().swap(log_head);
 }
@@ -43,7 +43,7 @@ Waypoint::Waypoint(char *line, Route *rte, ErrorList& el, char*const wptdata)
 		if (!c && !strncmp(label.data(), "http", 4))				// If the "label" is a URL, and the only field...
 		{	label = "..."+label.substr(label.size()-DBFieldLength::label+3);// the end is more useful than "http://www.openstreetma..."
 			while (label[3] < 0)	label.erase(label.begin()+3);		// Strip any partial multi-byte characters off the beginning
-			Datacheck::add(route, label, "", "", "SINGLE_FIELD_LINE", "");
+			Datacheck::add(route, Datacheck::keep(std::string(label)), 0, 0, Datacheck::SINGLE_FIELD_LINE);
 			throw 1;
 		}
 		// LABEL_TOO_LONG
@@ -56,12 +56,12 @@ Waypoint::Waypoint(char *line, Route *rte, ErrorList& el, char*const wptdata)
 			excess += "...";						// and append "..."
 		}
 		label.assign(label, 0, slicepoint);					// Now truncate the label itself
-		Datacheck::add(route, label+"...", "", "", "LABEL_TOO_LONG", "..."+excess);
+		Datacheck::add(route, Datacheck::keep(label+"..."), 0, 0, Datacheck::LABEL_TOO_LONG, "..."+excess);
 		invalid_line = 2;
 	}
 	// SINGLE_FIELD_LINE, looks like a label
 	if (!c)
-	{	Datacheck::add(route, label, "", "", "SINGLE_FIELD_LINE", "");
+	{	Datacheck::add(route, Datacheck::keep(std::string(label)), 0, 0, Datacheck::SINGLE_FIELD_LINE);
 		throw invalid_line | 4;
 	}
 
@@ -76,11 +76,11 @@ Waypoint::Waypoint(char *line, Route *rte, ErrorList& el, char*const wptdata)
 			break;
 		   }
 		while (*++d);
-		Datacheck::add(route, label, "", "", "MALFORMED_URL", shortgood ? c : "MISSING_ARG(S)");
+		Datacheck::add(route, Datacheck::keep(std::string(label)), 0, 0, Datacheck::MALFORMED_URL, shortgood ? c : "MISSING_ARG(S)");
 		throw invalid_line | 8;
 	}
-	if (!valid_num_str(latBeg, '&')) {invalid_url(latBeg, "MALFORMED_LAT"); invalid_line |= 16;}
-	if (!valid_num_str(lonBeg, '&')) {invalid_url(lonBeg, "MALFORMED_LON"); invalid_line |= 32;}
+	if (!valid_num_str(latBeg, '&')) {invalid_url(latBeg, Datacheck::MALFORMED_LAT); invalid_line |= 16;}
+	if (!valid_num_str(lonBeg, '&')) {invalid_url(lonBeg, Datacheck::MALFORMED_LON); invalid_line |= 32;}
 	if (invalid_line) throw invalid_line;
 	lat = atof(latBeg);
 	lng = atof(lonBeg);
@@ -104,15 +104,25 @@ bool Waypoint::nearby(Waypoint *other, double tolerance)
 	return fabs(lat - other->lat) < tolerance && fabs(lng - other->lng) < tolerance;
 }
 
-double Waypoint::distance_to(Waypoint *other)
-{	/* return the distance in miles between this waypoint and another
+Waypoint::Trig::Trig(Waypoint* w, size_t n): rlat(n), rlng(n), cos_lat(n), x(n), y(n), z(n)
+{	// convert to radians
+	for (size_t i = 0; i < n; i++)
+	{	rlat[i] = w[i].lat * (pi/180);
+		rlng[i] = w[i].lng * (pi/180);
+	}
+	// unit vectors, for angles
+	for (size_t i = 0; i < n; i++)
+	{	cos_lat[i] = cos(rlat[i]);
+		x[i] = cos(rlng[i])*cos_lat[i];
+		y[i] = sin(rlng[i])*cos_lat[i];
+		z[i] = sin(rlat[i]);
+	}
+}
+
+double Waypoint::Trig::distance(size_t i)
+{	/* return the distance in miles between waypoints i-1 and i
 	including the factor defined by the CHM project to adjust for
 	unplotted curves in routes */
-	// convert to radians
-	double rlat1 = lat * (pi/180);
-	double rlng1 = lng * (pi/180);
-	double rlat2 = other->lat * (pi/180);
-	double rlng2 = other->lng * (pi/180);
 
 	/* original formula
 	double ans = acos(cos(rlat1)*cos(rlng1)*cos(rlat2)*cos(rlng2) +\
@@ -130,33 +140,17 @@ double Waypoint::distance_to(Waypoint *other)
 	      ) * 3963.1; /* EARTH_RADIUS */
 
 	// haversine formula
-	double ans = asin(sqrt(pow(sin((rlat2-rlat1)/2),2) + cos(rlat1) * cos(rlat2) * pow(sin((rlng2-rlng1)/2),2))) * 7926.2; /* EARTH_DIAMETER */
+	double ans = asin(sqrt(pow(sin((rlat[i]-rlat[i-1])/2),2) + cos_lat[i-1] * cos_lat[i] * pow(sin((rlng[i]-rlng[i-1])/2),2))) * 7926.2; /* EARTH_DIAMETER */
 
 	return ans * 1.02112; // CHM/TM distance fudge factor to compensate for imprecision of mapping
 }
 
-double Waypoint::angle()
-{	/* return the angle in degrees formed by the waypoints between the
-	line from pred to self and self to succ */
-	// convert to radians
-	double rlatself = lat * (pi/180);
-	double rlngself = lng * (pi/180);
-	double rlatpred = this[-1].lat * (pi/180);
-	double rlngpred = this[-1].lng * (pi/180);
-	double rlatsucc = this[1].lat * (pi/180);
-	double rlngsucc = this[1].lng * (pi/180);
-
-	double x0 = cos(rlngpred)*cos(rlatpred);
-	double x1 = cos(rlngself)*cos(rlatself);
-	double x2 = cos(rlngsucc)*cos(rlatsucc);
-
-	double y0 = sin(rlngpred)*cos(rlatpred);
-	double y1 = sin(rlngself)*cos(rlatself);
-	double y2 = sin(rlngsucc)*cos(rlatsucc);
-
-	double z0 = sin(rlatpred);
-	double z1 = sin(rlatself);
-	double z2 = sin(rlatsucc);
+double Waypoint::Trig::angle(size_t i)
+{	/* return the angle in degrees formed by waypoint i between the
+	line from its predecessor to it and it to its successor */
+	double x0 = x[i-1], x1 = x[i], x2 = x[i+1];
+	double y0 = y[i-1], y1 = y[i], y2 = y[i+1];
+	double z0 = z[i-1], z1 = z[i], z2 = z[i+1];
 
 	return acos
 	(	( (x2-x1)*(x1-x0) + (y2-y1)*(y1-y0) + (z2-z1)*(z1-z0) )
@@ -167,17 +161,23 @@ double Waypoint::angle()
 	*180/pi;
 }
 
-std::string Waypoint::simple_waypoint_name()
+void Waypoint::simple_waypoint_name(std::string& name)
 {	/* Failsafe name for a point, simply the string of route name @
 	label, concatenated with & characters for colocated points. */
-	if (!colocated) return route->list_entry_name() + "@" + label;
-	std::string long_label;
+	name.clear();
+	if (!colocated)
+	{	route->append_list_entry_name(name);
+		name += '@';
+		name += label;
+		return;
+	}
 	for (Waypoint *w : *colocated)
 	  if (w->route->system->active_or_preview())
-	  {	if (!long_label.empty()) long_label += "&";
-		long_label += w->route->list_entry_name() + "@" + w->label;
+	  {	if (!name.empty()) name += '&';
+		w->route->append_list_entry_name(name);
+		name += '@';
+		name += w->label;
 	  }
-	return long_label;
 }
 
 bool Waypoint::is_or_colocated_with_active_or_preview()
@@ -209,7 +209,8 @@ void Waypoint::nmplogs(std::unordered_set<std::string> &nmpfps, std::ofstream &n
 			if (li) li_count++;
 			// make sure we only plot once, since the NMP should be listed
 			// both ways (other_w in w's list, w in other_w's list)
-			if (sort_root_at_label(this, other_w))
+			// unless other_w is outside a datacheck scope & won't list its own
+			if (sort_root_at_label(this, other_w) || !other_w->route->in_scope())
 			{	char s[51];
 				nmpnmp << root_at_label();
 				*fmt::format_to(s, " {:.15}", lat)=0; nmpnmp<<s;
@@ -258,10 +259,9 @@ Waypoint* Waypoint::hashpoint()
 }
 
 bool Waypoint::label_references_route(Route *r)
-{	std::string no_abbrev = r->name_no_abbrev();
-	if ( strncmp(label.data(), no_abbrev.data(), no_abbrev.size()) )
+{	if ( !r->no_abbrev_begins(label.data()) )
 		return 0;
-	const char* c = label.data() + no_abbrev.size();
+	const char* c = label.data() + r->route.size() + r->banner.size();
 	if (*c == 0 || *c == '_')
 		return 1;
 	if ( strncmp(c, r->abbrev.data(), r->abbrev.size()) )
@@ -361,7 +361,7 @@ void Waypoint::hidden_junction()
 		//	If we find a visible point, return.
 		// 2.	If we do find one, there's our VISIBLE_HIDDEN_COLOC error, so return that.
 		if (!w->is_hidden)
-			return Datacheck::add(w->route, w->label, "", "", "VISIBLE_HIDDEN_COLOC", root_at_label());
+			return Datacheck::add(w->route, &w->label, 0, 0, Datacheck::VISIBLE_HIDDEN_COLOC, this);
 		size_t index = w - w->route->points.data;
 		if (index)					      // unless 1st point in route,
 			add_to_adjacent(adjacent, w->route->segments[index-1]);	// add prev segment
@@ -369,23 +369,23 @@ void Waypoint::hidden_junction()
 			add_to_adjacent(adjacent, w->route->segments[index]);	// add next segment
 	}
 	if (adjacent.size() > 2 || adjacent.size() == 2 && colocated && !adjacent[0]->same_vis_routes(adjacent[1]))
-		Datacheck::add( route, label, "", "", "HIDDEN_JUNCTION", std::to_string(adjacent.size())/*+cat_seg(adjacent)*/ );
+		Datacheck::add( route, &label, 0, 0, Datacheck::HIDDEN_JUNCTION, adjacent.size()/*+cat_seg(adjacent)*/ );
 }
 
-void Waypoint::invalid_url(const char* const cstr, const char* const errcode)
+void Waypoint::invalid_url(const char* const cstr, unsigned char const errcode)
 {	std::string str(cstr, strcspn(cstr, "&"));
 	if (str.size() > DBFieldLength::dcErrValue)
 	{	str.assign(str, 0, DBFieldLength::dcErrValue-3);
 		while (str.back() < 0)	str.pop_back();
 		str += "...";
 	}
-	Datacheck::add(route, label, "", "", errcode, str);
+	Datacheck::add(route, Datacheck::keep(std::string(label)), 0, 0, Datacheck::Code(errcode), std::move(str));
 }
 
 void Waypoint::out_of_bounds()
 {	// out-of-bounds coords
 	if (lat > 90 || lat < -90 || lng > 180 || lng < -180)
-	  Datacheck::add(route, label, "", "", "OUT_OF_BOUNDS", fmt::format("({:.15},{:.15})", lat, lng));
+	  Datacheck::add(route, &label, 0, 0, Datacheck::OUT_OF_BOUNDS, this);
 }
 
 /* checks for visible points */
@@ -402,14 +402,14 @@ void Waypoint::bus_with_i()
 	if ( (*c == 'B' || *c == 'b')
 	  && (*(c+1) == 'u' || *(c+1) == 'U')
 	  && (*(c+2) == 's' || *(c+2) == 'S') )
-		Datacheck::add(route, label, "", "", "BUS_WITH_I", "");
+		Datacheck::add(route, &label, 0, 0, Datacheck::BUS_WITH_I);
 }
 
 void Waypoint::interstate_no_hyphen()
 {	const char *c = label[0] == '*' ? label.data()+1 : label.data();
 	if (c[0] == 'T' && c[1] == 'o') c += 2;
 	if (c[0] == 'I' && isdigit(c[1]))
-	  Datacheck::add(route, label, "", "", "INTERSTATE_NO_HYPHEN", "");
+	  Datacheck::add(route, &label, 0, 0, Datacheck::INTERSTATE_NO_HYPHEN);
 }
 
 void Waypoint::label_invalid_ends()
@@ -417,9 +417,9 @@ void Waypoint::label_invalid_ends()
 	const char *c = label.data();
 	while (*c == '*') c++;
 	if (*c == '_' || *c == '/' || *c == '(')
-		Datacheck::add(route, label, "", "", "INVALID_FIRST_CHAR", std::string(1, *c));
+		Datacheck::add(route, &label, 0, 0, Datacheck::INVALID_FIRST_CHAR, std::string(1, *c));
 	if (label.back() == '_' || label.back() == '/')
-		Datacheck::add(route, label, "", "", "INVALID_FINAL_CHAR", std::string(1, label.back()));
+		Datacheck::add(route, &label, 0, 0, Datacheck::INVALID_FINAL_CHAR, std::string(1, label.back()));
 }
 
 void Waypoint::label_looks_hidden()
@@ -432,11 +432,11 @@ void Waypoint::label_looks_hidden()
 	if (label[4] < '0' || label[4] > '9')	return;
 	if (label[5] < '0' || label[5] > '9')	return;
 	if (label[6] < '0' || label[6] > '9')	return;
-	Datacheck::add(route, label, "", "", "LABEL_LOOKS_HIDDEN", "");
+	Datacheck::add(route, &label, 0, 0, Datacheck::LABEL_LOOKS_HIDDEN);
 }
 
 void Waypoint::label_lowercase()
-{	if (islower(label[label[0]=='*'])) Datacheck::add(route, label, "", "", "LABEL_LOWERCASE", "");
+{	if (islower(label[label[0]=='*'])) Datacheck::add(route, &label, 0, 0, Datacheck::LABEL_LOWERCASE);
 }
 
 void Waypoint::label_parens()
@@ -447,7 +447,7 @@ void Waypoint::label_parens()
 	for (const char *c = label.data(); *c; c++)
 	{	if (*c == '(')
 		     {	if (left)
-			{	Datacheck::add(route, label, "", "", "LABEL_PARENS", "");
+			{	Datacheck::add(route, &label, 0, 0, Datacheck::LABEL_PARENS);
 				return;
 			}
 			left = c;
@@ -459,12 +459,12 @@ void Waypoint::label_parens()
 		     }
 	}
 	if (parens || right < left)
-		Datacheck::add(route, label, "", "", "LABEL_PARENS", "");
+		Datacheck::add(route, &label, 0, 0, Datacheck::LABEL_PARENS);
 }
 
 void Waypoint::label_selfref()
 {	// "label references own route"
-	#define FLAG(SUBTYPE) Datacheck::add(route, label, "", "", "LABEL_SELFREF", SUBTYPE)
+	#define FLAG(SUBTYPE) Datacheck::add(route, &label, 0, 0, Datacheck::LABEL_SELFREF, SUBTYPE)
 	const char* l = label.data() + (label[0] == '*');
 	std::string rte = route->banner[0] == '-' ? route->route : route->name_no_abbrev();
 	// first check for number match after a slash, if there is one
@@ -509,7 +509,7 @@ void Waypoint::label_selfref()
 void Waypoint::label_slashes(const char *slash)
 {	// look for too many slashes in label
 	if (slash && strchr(slash+1, '/'))
-		Datacheck::add(route, label, "", "", "LABEL_SLASHES", "");
+		Datacheck::add(route, &label, 0, 0, Datacheck::LABEL_SLASHES);
 }
 
 void Waypoint::lacks_generic()
@@ -519,7 +519,7 @@ void Waypoint::lacks_generic()
 	  && (*(c+1) == 'l' || *(c+1) == 'L')
 	  && (*(c+2) == 'd' || *(c+2) == 'D')
 	  &&  *(c+3) >= '0' && *(c+3) <= '9')
-		Datacheck::add(route, label, "", "", "LACKS_GENERIC", "");
+		Datacheck::add(route, &label, 0, 0, Datacheck::LACKS_GENERIC);
 }
 
 void Waypoint::underscore_datachecks(const char *slash)
@@ -527,17 +527,17 @@ void Waypoint::underscore_datachecks(const char *slash)
 	if (underscore)
 	{	// look for too many underscores in label
 		if (strchr(underscore+1, '_'))
-			Datacheck::add(route, label, "", "", "LABEL_UNDERSCORES", "");
+			Datacheck::add(route, &label, 0, 0, Datacheck::LABEL_UNDERSCORES);
 		// look for too many characters after underscore in label
 		if (label.data()+label.size() > underscore+4)
 		    if (label.back() > 'Z' || label.back() < 'A' || label.data()+label.size() > underscore+5)
-			Datacheck::add(route, label, "", "", "LONG_UNDERSCORE", "");
+			Datacheck::add(route, &label, 0, 0, Datacheck::LONG_UNDERSCORE);
 		// look for labels with a slash after an underscore
 		if (slash > underscore)
-			Datacheck::add(route, label, "", "", "NONTERMINAL_UNDERSCORE", "");
+			Datacheck::add(route, &label, 0, 0, Datacheck::NONTERMINAL_UNDERSCORE);
 		// look for suffix starting with lowercase letter
 		if (islower(underscore[1]))
-			Datacheck::add(route, label, "", "", "LOWERCASE_SUFFIX", "");
+			Datacheck::add(route, &label, 0, 0, Datacheck::LOWERCASE_SUFFIX);
 	}
 }
 
@@ -549,20 +549,20 @@ void Waypoint::us_letter()
 	while (*c >= '0' && *c <= '9')	c++;
 	if (*c    < 'A' || *c++  > 'B')	return;
 	if (*c == 0 || *c == '/' || *c == '_' || *c == '(')
-		Datacheck::add(route, label, "", "", "US_LETTER", "");
+		Datacheck::add(route, &label, 0, 0, Datacheck::US_LETTER);
 	// is it followed by a city abbrev?
 	else if (*c >= 'A' && *c++ <= 'Z'
 	      && *c >= 'a' && *c++ <= 'z'
 	      && *c >= 'a' && *c++ <= 'z'
 	      && *c == 0 || *c == '/' || *c == '_' || *c == '(')
-		Datacheck::add(route, label, "", "", "US_LETTER", "");
+		Datacheck::add(route, &label, 0, 0, Datacheck::US_LETTER);
 }
 
 void Waypoint::visible_distance(double &vis_dist, Waypoint *&last_visible)
 {	// complete visible distance check, omit report for active
 	// systems to reduce clutter
 	if (vis_dist > 10 && !route->system->active())
-	  Datacheck::add(route, last_visible->label, label, "", "VISIBLE_DISTANCE", fmt::format("{:.2f}", vis_dist));
+	  Datacheck::add(route, &last_visible->label, &label, 0, Datacheck::VISIBLE_DISTANCE, vis_dist);
 	last_visible = this;
 	vis_dist = 0;
 }
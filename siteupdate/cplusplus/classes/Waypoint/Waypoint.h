@@ -21,6 +21,16 @@ class Waypoint
     */
 
 	public:
+	struct Trig
+	{	// of each of a route's waypoints, computed once,
+		// in structure-of-arrays form for tight loops
+		std::vector<double> rlat, rlng, cos_lat, x, y, z;
+
+		Trig(Waypoint*, size_t);
+		double distance(size_t);
+		double angle(size_t);
+	};
+
 	Route *route;
 	std::list<Waypoint*> *colocated;
 	HGVertex *vertex;
@@ -36,10 +46,8 @@ class Waypoint
 	std::string str();
 	bool same_coords(Waypoint *);
 	bool nearby(Waypoint *, double);
-	double distance_to(Waypoint *);
-	double angle();
-	std::string canonical_waypoint_name(HighwayGraph*);
-	std::string simple_waypoint_name();
+	unsigned char canonical_waypoint_name(std::string&, HighwayGraph*, const char**);
+	void simple_waypoint_name(std::string&);
 	bool is_or_colocated_with_active_or_preview();
 	std::string root_at_label();
 	void nmplogs(std::unordered_set<std::string> &, std::ofstream &, std::list<std::string> &);
@@ -55,7 +63,7 @@ class Waypoint
 
 	// Datacheck
 	void hidden_junction();
-	void invalid_url(const char* const, const char* const);
+	void invalid_url(const char* const, unsigned char const);
 	void out_of_bounds();
 	// checks for visible points
 	void bus_with_i();
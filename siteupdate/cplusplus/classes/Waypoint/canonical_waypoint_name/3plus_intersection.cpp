@@ -15,32 +15,37 @@
 // the abbrev field (which they often do not)
 if (ap_coloc.size() > 2)
 {	bool match;
-	std::vector<std::string> suffixes(ap_coloc.size());
+	// suffixes point into labels; reuse the thread's vector from one point to the next
+	static thread_local std::vector<const char*> suffixes;
+	suffixes.assign(ap_coloc.size(), "");
 	for (unsigned int check = 0; check < ap_coloc.size(); check++)
 	{	match = 0;
 		for (unsigned int other = 0; other < ap_coloc.size(); other++)
 		{	if (other == check) continue;
-			std::string other_no_abbrev = ap_coloc[other]->route->name_no_abbrev();
-			if ( !strncmp(ap_coloc[check]->label.data(), other_no_abbrev.data(), other_no_abbrev.size()) )
+			Route* const o = ap_coloc[other]->route;
+			if ( o->no_abbrev_begins(ap_coloc[check]->label.data()) )
 			{	// should check here for false matches, like
 				// NY50/67 would match startswith NY5
 				match = 1;
 				const char* suffix = strchr(ap_coloc[check]->label.data(), '_');
+				// we confirmed above that name_no_abbrev() matches, so skip past it
+				const char* rest = ap_coloc[check]->label.data()+o->route.size()+o->banner.size();
 				if (suffix
-				// we confirmed above that other_no_abbrev matches, so skip past it
 				// we need only match the suffix with or without the abbrev
-				 && (!strcmp(ap_coloc[check]->label.data()+other_no_abbrev.size(), suffix)
-				  || ap_coloc[check]->label.data()+other_no_abbrev.size() == ap_coloc[other]->route->abbrev + suffix
+				 && (!strcmp(rest, suffix)
+				  || !strncmp(rest, o->abbrev.data(), o->abbrev.size()) && !strcmp(rest+o->abbrev.size(), suffix)
 				   ))	suffixes[other] = suffix;
 			}
 		}
 		if (!match) break;
 	}
 	if (match)
-	{	std::string newname = ap_coloc[0]->route->list_entry_name() + suffixes[0];
-		for (unsigned int index = 1; index < ap_coloc.size(); index++)
-			newname += '/' + ap_coloc[index]->route->list_entry_name() + suffixes[index];
-		g->namelog("3+_intersection: " + name + " -> " + newname);
-		return newname;
+	{	name.clear();
+		for (unsigned int index = 0; index < ap_coloc.size(); index++)
+		{	if (index) name += '/';
+			ap_coloc[index]->route->append_list_entry_name(name);
+			name += suffixes[index];
+		}
+		return HighwayGraph::three_plus_intersection;
 	}
 }
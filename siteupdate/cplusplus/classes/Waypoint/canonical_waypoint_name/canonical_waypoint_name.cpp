@@ -1,20 +1,37 @@
 #include "../Waypoint.h"
 #include "../../GraphGeneration/HighwayGraph.h"
 #include "../../Route/Route.h"
-#include "../../../templates/contains.cpp"
 #include <cstring>
 
-std::string Waypoint::canonical_waypoint_name(HighwayGraph* g)
+static bool exit_paren(std::string& label, std::string& exit, Route* r, size_t from)
+{	// does label == exit + '(' + r->name_no_abbrev().substr(from) + ')' ?
+	size_t const rs = r->route.size();
+	if (	label.size() != exit.size() + rs + r->banner.size() - from + 2
+	     || label.compare(0, exit.size(), exit)
+	     || label[exit.size()] != '('
+	     || label.back() != ')'
+	   )	return 0;
+	const char* c = label.data() + exit.size() + 1;
+	if (from < rs)
+	{	if (memcmp(c, r->route.data()+from, rs-from)) return 0;
+		c += rs-from;
+		from = rs;
+	}
+	return !memcmp(c, r->banner.data()+from-rs, r->banner.size()-from+rs);
+}
+
+unsigned char Waypoint::canonical_waypoint_name(std::string& name, HighwayGraph* g, const char** taken)
 {	/* Best name we can come up with for this point bringing in
 	information from itself and colocated points (if active/preview)
+	Built in name, which the caller reuses from one point to the next.
+	Returns the rule that produced it, for the waypoint simplification log.
 	*/
-	// start with the failsafe name, and see if we can improve before
-	// returning
-	std::string name = simple_waypoint_name();
-
 	// if no colocated active/preview points, there's nothing to do - we
-	// just return the simple name and deal with conflicts elsewhere
-	if (ap_coloc.size() == 1) return name;
+	// just use the simple name and deal with conflicts elsewhere
+	if (ap_coloc.size() == 1)
+	{	simple_waypoint_name(name);
+		return HighwayGraph::no_rule;
+	}
 
 	#include "straightforward_intersection.cpp"
 	#include "straightforward_concurrency.cpp"
@@ -23,6 +40,7 @@ std::string Waypoint::canonical_waypoint_name(HighwayGraph* g)
 	#include "3plus_intersection.cpp"
 	#include "reversed_border_labels.cpp"
 
-	g->namelog("Keep_failsafe: " + name);
-	return name;
+	// if we can't improve on it, use the failsafe name
+	simple_waypoint_name(name);
+	return HighwayGraph::keep_failsafe;
 }
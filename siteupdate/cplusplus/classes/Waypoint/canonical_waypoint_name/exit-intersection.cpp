@@ -13,27 +13,25 @@
 // US20/NY30A/NY162
 
 for (Waypoint* match : ap_coloc)
-{	std::string no_abbrev = match->route->name_no_abbrev();
-	size_t list_name_size = no_abbrev.size()+match->route->abbrev.size();
+{	size_t no_abbrev_size = match->route->route.size()+match->route->banner.size();
+	size_t list_name_size = no_abbrev_size+match->route->abbrev.size();
 	bool all_match = 1;
 	for (Waypoint* check : ap_coloc)
 	{	if (check == match) continue;
 
 		// if name_no_abbrev() matches, check for...
-		if ( !strncmp(check->label.data(),
-			      no_abbrev.data(),
-			      no_abbrev.size())
-		   ) {	if (	check->label[no_abbrev.size()] == 0	// no_abbrev match
+		if ( match->route->no_abbrev_begins(check->label.data())
+		   ) {	if (	check->label[no_abbrev_size] == 0	// no_abbrev match
 			   )	continue;
-			if (	check->label[no_abbrev.size()] == '('
-			     && !strncmp(check->label.data()+no_abbrev.size()+1,
+			if (	check->label[no_abbrev_size] == '('
+			     && !strncmp(check->label.data()+no_abbrev_size+1,
 					 match->label.data(),
 					 match->label.size())
-			     && check->label[no_abbrev.size()+match->label.size()+1] == ')'
+			     && check->label[no_abbrev_size+match->label.size()+1] == ')'
 			   )	continue;				// match with exit number in parens
 
 			// if abbrev matches, check for...
-			if ( !strncmp(check->label.data()+no_abbrev.size(),
+			if ( !strncmp(check->label.data()+no_abbrev_size,
 				      match->route->abbrev.data(),
 				      match->route->abbrev.size())
 			   ) {	if (	check->label[list_name_size] == 0	// full match with abbrev field
@@ -50,16 +48,20 @@ for (Waypoint* match : ap_coloc)
 		break;
 	}
 	if (all_match)
-	{	std::string newname(match->route->list_entry_name());
+	{	name.clear();
+		match->route->append_list_entry_name(name);
 		if (match->label[0] >= '0' && match->label[0] <= '9')
-			newname +=  '(' + match->label + ')';
+		{	name += '(';
+			name += match->label;
+			name += ')';
+		}
 		for (unsigned int add_index = 0; add_index < ap_coloc.size(); add_index++)
 		{	if (match == ap_coloc[add_index]
 			 || (add_index && ap_coloc[add_index]->route == ap_coloc[add_index-1]->route)
 			   ) continue;
-			newname += '/' + ap_coloc[add_index]->route->list_entry_name();
+			name += '/';
+			ap_coloc[add_index]->route->append_list_entry_name(name);
 		}
-		g->namelog("Exit/Intersection: " + name + " -> " + newname);
-		return newname;
+		return HighwayGraph::exit_intersection;
 	}
 }
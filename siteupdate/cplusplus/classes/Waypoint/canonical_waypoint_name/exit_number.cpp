@@ -20,14 +20,16 @@ for (Waypoint* exit : ap_coloc)
 	// when considering the one at exit as a primary
 	// exit number
 	if (exit->label[0] < '0' || exit->label[0] > '9') continue;
-	std::string no_abbrev = exit->route->name_no_abbrev();
-	std::string nmbr_only = no_abbrev; // route number only version
-	for (unsigned int pos = 0; pos < nmbr_only.size(); pos++)
-	  if (nmbr_only[pos] >= '0' && nmbr_only[pos] <= '9')
-	  {	nmbr_only = nmbr_only.data()+pos;
+	size_t no_abbrev_size = exit->route->route.size()+exit->route->banner.size();
+	size_t nmbr_only = 0; // where the route number only version begins
+	for (unsigned int pos = 0; pos < no_abbrev_size; pos++)
+	{ char const c = pos < exit->route->route.size() ? exit->route->route[pos] : exit->route->banner[pos-exit->route->route.size()];
+	  if (c >= '0' && c <= '9')
+	  {	nmbr_only = pos;
 		break;
 	  }
-	size_t list_name_size = no_abbrev.size()+exit->route->abbrev.size();
+	}
+	size_t list_name_size = no_abbrev_size+exit->route->abbrev.size();
 
 	bool all_match = 1;
 	for (Waypoint* match : ap_coloc)
@@ -35,22 +37,20 @@ for (Waypoint* exit : ap_coloc)
 		// check for any of the patterns that make sense as a match:
 
 		// if name_no_abbrev() matches, check for...
-		if ( !strncmp(match->label.data(),
-			      no_abbrev.data(),
-			      no_abbrev.size())
-		   ) {	if (	match->label[no_abbrev.size()] == 0	// full match without abbrev field
-			     || match->label[no_abbrev.size()] == '_'	// match with _ suffix (like _N)
-			     || match->label[no_abbrev.size()] == '/'	// match with a slash
+		if ( exit->route->no_abbrev_begins(match->label.data())
+		   ) {	if (	match->label[no_abbrev_size] == 0	// full match without abbrev field
+			     || match->label[no_abbrev_size] == '_'	// match with _ suffix (like _N)
+			     || match->label[no_abbrev_size] == '/'	// match with a slash
 			   )	continue;
-			if (	match->label[no_abbrev.size()] == '('
-			     && !strncmp(match->label.data()+no_abbrev.size()+1,
+			if (	match->label[no_abbrev_size] == '('
+			     && !strncmp(match->label.data()+no_abbrev_size+1,
 					 exit->label.data(),
 					 exit->label.size())
-			     && match->label[no_abbrev.size()+exit->label.size()+1] == ')'
+			     && match->label[no_abbrev_size+exit->label.size()+1] == ')'
 			   )	continue;				// match with exit number in parens
 
 			// if abbrev matches, check for...
-			if ( !strncmp(match->label.data()+no_abbrev.size(),
+			if ( !strncmp(match->label.data()+no_abbrev_size,
 				      exit->route->abbrev.data(),
 				      exit->route->abbrev.size())
 			   ) {	if (	match->label[list_name_size] == 0	// full match with abbrev field
@@ -66,20 +66,25 @@ for (Waypoint* exit : ap_coloc)
 			     }
 		     }
 
-		if (match->label != exit->label				 // match with exit number only
-		 && match->label != exit->label + '(' + nmbr_only + ')'	 // match concurrency exit
-		 && match->label != exit->label + '(' + no_abbrev + ')') // number format nn(rr)
+		if (match->label != exit->label					  // match with exit number only
+		 && !exit_paren(match->label, exit->label, exit->route, nmbr_only) // match concurrency exit
+		 && !exit_paren(match->label, exit->label, exit->route, 0))	  // number format nn(rr)
 		{	all_match = 0;
 			break;
 		}
 	}
 	if (all_match)
-	{	std::string newname(exit->route->list_entry_name() + '(' + exit->label + ')');
+	{	name.clear();
+		exit->route->append_list_entry_name(name);
+		name += '(';
+		name += exit->label;
+		name += ')';
 		for (unsigned int pos = 0; pos < ap_coloc.size(); pos++)
 		{	if (ap_coloc[pos] != exit)
-				newname += '/' + ap_coloc[pos]->route->list_entry_name();
+			{	name += '/';
+				ap_coloc[pos]->route->append_list_entry_name(name);
+			}
 		}
-		g->namelog("Exit_number: " + name + " -> " + newname);
-		return newname;
+		return HighwayGraph::exit_number;
 	}
 }
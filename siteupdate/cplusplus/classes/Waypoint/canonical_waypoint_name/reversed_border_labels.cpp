@@ -5,24 +5,31 @@
 
 const char *slash = strchr(label.data(), '/');
 if (slash)
-{	std::string reverse = (slash+1)+('/'+label.substr(0, slash-label.data()));
+{	// compare to the reversed label, slash+1 + '/' + everything before the slash
+	size_t const before = slash-label.data(), after = label.size()-before-1;
+	auto reverse = [&](std::string& l)
+	{	return l.size() == label.size()
+		    && !l.compare(0, after, label, before+1, after)
+		    && l[after] == '/'
+		    && !l.compare(after+1, before, label, 0, before);
+	};
 	unsigned int matches = 1;
 	// ap_coloc[0]->label *IS* label, so no need to check that
 	while (matches < ap_coloc.size())
-	  if (ap_coloc[matches]->label == label || ap_coloc[matches]->label == reverse)
+	  if (ap_coloc[matches]->label == label || reverse(ap_coloc[matches]->label))
 	    matches++;
 	  else break;
 	if (matches == ap_coloc.size())
-	{	std::vector<std::string> routes;
-		for (Waypoint *w : ap_coloc)
-			if (!contains(routes, w->route->list_entry_name()))
-				routes.push_back(w->route->list_entry_name());
-
-		std::string newname = routes[0];
-		for (unsigned int i = 1; i < routes.size(); i++)
-			newname += '/' + routes[i];
-		newname += '@' + label;
-		g->namelog("Reversed_border_labels: " + name + " -> " + newname);
-		return newname;
+	{	name.clear();
+		for (unsigned int i = 0; i < ap_coloc.size(); i++)
+		{	unsigned int prev = 0;
+			while (prev < i && !ap_coloc[prev]->route->same_list_entry_name(ap_coloc[i]->route)) prev++;
+			if (prev < i) continue;
+			if (i) name += '/';
+			ap_coloc[i]->route->append_list_entry_name(name);
+		}
+		name += '@';
+		name += label;
+		return HighwayGraph::reversed_border_labels;
 	}
 }
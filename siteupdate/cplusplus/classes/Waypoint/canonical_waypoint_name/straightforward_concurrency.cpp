@@ -13,22 +13,22 @@
 //	 I-95 doesn't have a point here, due to a double trumpet.
 //  TRY: Use (suffix) if all are the same; else drop
 
-std::list<std::string> routes;
 unsigned int matches = 0;
 for (Waypoint *w : ap_coloc)
   if (ap_coloc.front()->label == w->label || w->label[0] == '+')
-  {	// avoid double route names at border crossings
-	if (!contains(routes, w->route->list_entry_name()))
-		routes.push_back(w->route->list_entry_name());
 	matches++;
-  }
   else break;
 if (matches == ap_coloc.size())
-{	std::string newname;
-	for (std::string &r : routes)
-		newname += '/' + r;
-	newname = newname.data()+1;
-	newname += '@' + ap_coloc.front()->label;
-	g->namelog("Straightforward_concurrency: " + name + " -> " + newname);
-	return newname;
+{	name.clear();
+	for (unsigned int i = 0; i < ap_coloc.size(); i++)
+	{	// avoid double route names at border crossings
+		unsigned int prev = 0;
+		while (prev < i && !ap_coloc[prev]->route->same_list_entry_name(ap_coloc[i]->route)) prev++;
+		if (prev < i) continue;
+		if (i) name += '/';
+		ap_coloc[i]->route->append_list_entry_name(name);
+	}
+	name += '@';
+	name += ap_coloc.front()->label;
+	return HighwayGraph::straightforward_concurrency;
 }
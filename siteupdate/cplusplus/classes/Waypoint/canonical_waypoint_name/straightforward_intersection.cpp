@@ -8,23 +8,22 @@
 if (	ap_coloc.size() == 2
      &&	ap_coloc[1]->label_references_route(ap_coloc[0]->route)
      &&	ap_coloc[0]->label_references_route(ap_coloc[1]->route)
-   ) {	std::string newname = ap_coloc[1]->label+'/'+ap_coloc[0]->label;
+   ) {	name.assign(ap_coloc[1]->label);
+	name += '/';
+	name += ap_coloc[0]->label;
 	// if this is taken or if name_no_abbrev()s match, attempt to add in abbrevs if there's point in doing so
 	if (ap_coloc[0]->route->abbrev.size() || ap_coloc[1]->route->abbrev.size())
-	{	g->set_mtx[newname.back()].lock();
-		bool taken = g->vertex_names[newname.back()].count(newname);
-		g->set_mtx[newname.back()].unlock();
-		if (taken || ap_coloc[0]->route->name_no_abbrev() == ap_coloc[1]->route->name_no_abbrev())
+	{	*taken = g->vertex_names.find(name);
+		if (*taken || ap_coloc[0]->route->same_no_abbrev_name(ap_coloc[1]->route))
 		{	const char *u0 = strchr(ap_coloc[0]->label.data(), '_');
 			const char *u1 = strchr(ap_coloc[1]->label.data(), '_');
-			std::string newname = (ap_coloc[0]->route->list_entry_name() + (u1 ? u1 : "")) + '/'
-					    + (ap_coloc[1]->route->list_entry_name() + (u0 ? u0 : ""));
-			std::string message = "Straightforward_intersection: " + name + " -> " + newname;
-			if (taken) message += " (" + ap_coloc[1]->label+'/'+ap_coloc[0]->label + " already taken)";
-			g->namelog(std::move(message));
-			return newname;
+			name.clear();
+			ap_coloc[0]->route->append_list_entry_name(name);
+			if (u1) name += u1;
+			name += '/';
+			ap_coloc[1]->route->append_list_entry_name(name);
+			if (u0) name += u0;
 		}
 	}
-	g->namelog("Straightforward_intersection: " + name + " -> " + newname);
-	return newname;
+	return HighwayGraph::straightforward_intersection;
      }
@@ -49,6 +49,6 @@ auto validate_label = [&](char* lbl, char* end)
 	{	std::string str = end - lbl <= DBFieldLength::label
 		? std::string(lbl, end) // or cut down to fit in DB if needed. Likely to be URL, so save the end
 		: std::string("...").append(end - DBFieldLength::label + 3, DBFieldLength::label - 3);
-		Datacheck::add(rte, str, "", "", "LABEL_INVALID_CHAR", "");
+		Datacheck::add(rte, Datacheck::keep(std::move(str)), 0, 0, Datacheck::LABEL_INVALID_CHAR);
 	}
 };
@@ -65,8 +65,7 @@ void WaypointQuadtree::insert(Waypoint *w, bool init)
 				// DUPLICATE_COORDS datacheck
 				for (Waypoint* p : *other_w->colocated)
 				  if (p->route == w->route)
-				    Datacheck::add(w->route, p->label, w->label, "", "DUPLICATE_COORDS",
-						   fmt::format("({:.15},{:.15})", w->lat, w->lng));
+				    Datacheck::add(w->route, &p->label, &w->label, 0, Datacheck::DUPLICATE_COORDS, w);
 				other_w->colocated->push_back(w);
 				w->colocated = other_w->colocated;
 			}
@@ -123,6 +122,21 @@ void WaypointQuadtree::near_miss_waypoints(Waypoint *w, double tolerance)
 	     }
 }
 
+bool WaypointQuadtree::any_near(double lat, double lng, double tolerance)
+{	// whether any waypoint is colocated with or within the
+	// near-miss tolerance of the given coordinates
+	if (!refined())
+	{	for (Waypoint *p : points)
+		  if (fabs(p->lat - lat) <= tolerance && fabs(p->lng - lng) <= tolerance)
+			return 1;
+		return 0;
+	}
+	return	(lat + tolerance >= mid_lat && lng - tolerance <= mid_lng && nw_child->any_near(lat, lng, tolerance))
+	     || (lat + tolerance >= mid_lat && lng + tolerance >= mid_lng && ne_child->any_near(lat, lng, tolerance))
+	     || (lat - tolerance <= mid_lat && lng - tolerance <= mid_lng && sw_child->any_near(lat, lng, tolerance))
+	     || (lat - tolerance <= mid_lat && lng + tolerance >= mid_lng && se_child->any_near(lat, lng, tolerance));
+}
+
 void WaypointQuadtree::nmplogs()
 {	using namespace std;
 	// read in fp file
@@ -147,7 +161,9 @@ void WaypointQuadtree::nmplogs()
 	list<string> nmploglines;
 	ofstream nmplog(Args::logfilepath+"/nearmisspoints.log");
 	ofstream nmpnmp(Args::logfilepath+"/tm-master.nmp");
-	for (Waypoint *w : point_list()) w->nmplogs(nmpfps, nmpnmp, nmploglines);
+	for (Waypoint *w : point_list())
+	  if (w->route->in_scope())
+	    w->nmplogs(nmpfps, nmpnmp, nmploglines);
 	nmpnmp.close();
 
 	// sort and write actual lines to nearmisspoints.log
@@ -161,6 +177,8 @@ void WaypointQuadtree::nmplogs()
 	list<string> nmpfplist(nmpfps.begin(), nmpfps.end());
 	nmpfplist.sort();
 	for (string &line : nmpfplist)
+	  // entries for routes outside a datacheck scope went unchecked
+	  if (!Route::out_of_scope(line.substr(0, line.find(' '))))
 		nmpfpsunmatchedfile << line << '\n';
 	nmpfpsunmatchedfile.close();
 	nmpfplist.clear();
@@ -23,6 +23,7 @@ class WaypointQuadtree
 	void refine();
 	void insert(Waypoint*, bool);
 	void near_miss_waypoints(Waypoint*, double);
+	bool any_near(double, double, double);
 	void nmplogs();
 	std::string str();
 	unsigned int size();
@@ -3,6 +3,7 @@
 #include "../classes/Region/Region.h"
 #include "../classes/TravelerList/TravelerList.h"
 #include "../threads/threads.h"
+#include <algorithm>
 #include <fmt/format.h>
 #include <fstream>
 
@@ -10,26 +11,34 @@ void allbyregionactiveonly(std::mutex* mtx, double total_mi)
 {	char fstr[112];
 	std::ofstream allfile(Args::csvstatfilepath + "/allbyregionactiveonly.csv");
 	allfile << "Traveler,Total";
-	std::list<Region*> regions;
+	std::vector<Region*> regions;
+	std::vector<int> col(Region::allregions.size, -1); // each region's column, by index
 	for (Region& r : Region::allregions)
 	  if (r.active_only_mileage)
-	  {	regions.push_back(&r);
+	  {	col[&r - Region::allregions.data] = regions.size();
+		regions.push_back(&r);
 		allfile << ',' << r.code;
 	  }
 	allfile << '\n';
+	// a dense row of each traveler's mileage by region, -1 where there's no entry
+	std::vector<double> row(regions.size());
 	for (TravelerList& t : TravelerList::allusers)
 	{	double t_total_mi = 0;
+		std::fill(row.begin(), row.end(), -1);
 		for (std::pair<Region* const, double>& rm : t.active_only_mileage_by_region)
-			t_total_mi += rm.second;
+		{	t_total_mi += rm.second;
+			// regions with no active mileage have no column
+			int c = col[rm.first - Region::allregions.data];
+			if (c >= 0) row[c] = rm.second;
+		}
 		*fmt::format_to(fstr, "{:.2f}", t_total_mi) = 0;
 		allfile << t.traveler_name << ',' << fstr;
-		for (Region *region : regions)
-		{	auto it = t.active_only_mileage_by_region.find(region);
-			if (it != t.active_only_mileage_by_region.end())
-			{	*fmt::format_to(fstr, "{:.2f}", it->second) = 0;
+		for (double mi : row)
+		{	if (mi < 0)
+				allfile << ",0";
+			else {	*fmt::format_to(fstr, "{:.2f}", mi) = 0;
 				allfile << ',' << fstr;
-			}
-		  	else	allfile << ",0";
+			     }
 		}
 		allfile << '\n';
 	}
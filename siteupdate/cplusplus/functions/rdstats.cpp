@@ -6,7 +6,6 @@
 #include "../classes/Route/Route.h"
 #include <fmt/format.h>
 #include <fstream>
-#include <list>
 
 void rdstats(double& active_only_miles, double& active_preview_miles, time_t* timestamp)
 {	char fstr[112];
@@ -41,11 +40,7 @@ void rdstats(double& active_only_miles, double& active_preview_miles, time_t* ti
 		rdstatsfile << "System " << h.systemname << " (" << h.level_name() << fstr;
 		if (h.mileage_by_region.size() > 1)
 		{	rdstatsfile << "System " << h.systemname << " by region:\n";
-			std::list<Region*> regions_in_system;
-			for (auto& rm : h.mileage_by_region)
-				regions_in_system.push_back(rm.first);
-			regions_in_system.sort();
-			for (Region *r : regions_in_system)
+			for (Region *r : h.regions)
 			{	*fmt::format_to(fstr, ": {:.2f} mi\n", h.mileage_by_region.at(r)) = 0;
 				rdstatsfile << r->code << fstr;
 			}
@@ -1,13 +1,20 @@
 #include "../classes/Args/Args.h"
 #include "../classes/HighwaySystem/HighwaySystem.h"
 #include "../classes/Route/Route.h"
+#include <algorithm>
 #include <fstream>
 #include <string>
 
 void route_and_label_logs(time_t* timestamp)
 {	unsigned int total_unused_alt_labels = 0;
 	unsigned int total_unusedaltroutenames = 0;
-	std::list<std::string> unused_alt_labels;
+	std::vector<std::string> unused_alt_labels;
+	std::vector<const std::string*> names;	// reused for each sorted list of labels or route names
+	auto sort_names = [&](std::unordered_set<std::string>& set)
+	{	names.clear();
+		for (const std::string& n : set) names.push_back(&n);
+		std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b){return *a < *b;});
+	};
 	std::ofstream piufile(Args::logfilepath+"/pointsinuse.log");
 	std::ofstream lniufile(Args::logfilepath+"/listnamesinuse.log");
 	std::ofstream uarnfile(Args::logfilepath+"/unusedaltroutenames.log");
@@ -21,9 +28,8 @@ void route_and_label_logs(time_t* timestamp)
 		{	// labelsinuse.log line
 			if (r.labels_in_use.size())
 			{	piufile << r.root << '(' << r.points.size << "):";
-				std::list<std::string> liu_list(r.labels_in_use.begin(), r.labels_in_use.end());
-				liu_list.sort();
-				for (std::string& label : liu_list) piufile << ' ' << label;
+				sort_names(r.labels_in_use);
+				for (const std::string* label : names) piufile << ' ' << *label;
 				piufile << '\n';
 				r.labels_in_use.clear();
 			}
@@ -31,10 +37,9 @@ void route_and_label_logs(time_t* timestamp)
 			if (r.unused_alt_labels.size())
 			{	total_unused_alt_labels += r.unused_alt_labels.size();
 				std::string ual_entry = r.root + '(' + std::to_string(r.unused_alt_labels.size()) + "):";
-				std::list<std::string> ual_list(r.unused_alt_labels.begin(), r.unused_alt_labels.end());
-				ual_list.sort();
-				for (std::string& label : ual_list) ual_entry += ' ' + label;
-				unused_alt_labels.push_back(ual_entry);
+				sort_names(r.unused_alt_labels);
+				for (const std::string* label : names) ual_entry += ' ' + *label;
+				unused_alt_labels.emplace_back(std::move(ual_entry));
 				r.unused_alt_labels.clear();
 			}
 			// flippedroutes.log line
@@ -43,9 +48,8 @@ void route_and_label_logs(time_t* timestamp)
 		// listnamesinuse.log line
 		if (h.listnamesinuse.size())
 		{	lniufile << h.systemname << '(' << h.routes.size << "):";
-			std::list<std::string> lniu_list(h.listnamesinuse.begin(), h.listnamesinuse.end());
-			lniu_list.sort();
-			for (std::string& list_name : lniu_list) lniufile << " \"" << list_name << '"';
+			sort_names(h.listnamesinuse);
+			for (const std::string* list_name : names) lniufile << " \"" << *list_name << '"';
 			lniufile << '\n';
 			h.listnamesinuse.clear();
 		}
@@ -53,9 +57,8 @@ void route_and_label_logs(time_t* timestamp)
 		if (h.unusedaltroutenames.size())
 		{	total_unusedaltroutenames += h.unusedaltroutenames.size();
 			uarnfile << h.systemname << '(' << h.unusedaltroutenames.size() << "):";
-			std::list<std::string> uarn_list(h.unusedaltroutenames.begin(), h.unusedaltroutenames.end());
-			uarn_list.sort();
-			for (std::string& list_name : uarn_list) uarnfile << " \"" << list_name << '"';
+			sort_names(h.unusedaltroutenames);
+			for (const std::string* list_name : names) uarnfile << " \"" << *list_name << '"';
 			uarnfile << '\n';
 			h.unusedaltroutenames.clear();
 		}
@@ -66,12 +69,12 @@ void route_and_label_logs(time_t* timestamp)
 	uarnfile << "Total: " << total_unusedaltroutenames << '\n';
 	uarnfile.close();
 	// sort lines and write unusedaltlabels.log
-	unused_alt_labels.sort();
+	std::sort(unused_alt_labels.begin(), unused_alt_labels.end());
 	std::ofstream ualfile(Args::logfilepath+"/unusedaltlabels.log");
 	*timestamp = time(0);
 	ualfile << "Log file created at: " << ctime(timestamp);
 	for (std::string &ual_entry : unused_alt_labels) ualfile << ual_entry << '\n';
-	unused_alt_labels.clear();
+	std::vector<std::string>().swap(unused_alt_labels);
 	ualfile << "Total: " << total_unused_alt_labels << '\n';
 	ualfile.close();
 }
@@ -13,494 +13,1113 @@
 #include "../classes/Route/Route.h"
 #include "../classes/TravelerList/TravelerList.h"
 #include "../classes/Waypoint/Waypoint.h"
+#include <algorithm>
+#include <cstdio>
 #include <fmt/format.h>
 #include <fstream>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#ifdef threading_enabled
+#include <condition_variable>
+#include <thread>
+#endif
+
+// Delta SQL: each table's rows are hashed in groups -- a row, a traveler's or
+// a route's rows, or the whole table -- and compared with the groups listed in
+// the previous run's manifest. The .delta.sql script deletes the groups that
+// changed or went away, and inserts the new & changed ones.
+// Waypoints, segments & clinched are numbered in route order, so one route's
+// new waypoint renumbers everything after it. Their groups are routes, hashed
+// with IDs relative to the route's first point & segment; a route whose rows
+// only moved is renumbered with an UPDATE, merged into ranges of routes that
+// moved together. Moved rows are parked above id_offset until all tables'
+// inserts are in, so no ID is ever held by two rows.
+class SqlDelta
+{	public:
+	enum State : char {UNSEEN, SAME, CHANGED};
+	struct Group
+	{	uint64_t hash;
+		unsigned int base[2], count[2];	// first point & segment, and how many, for numbered tables
+		unsigned int moved[2];		// first point & segment this run
+		State state;
+	};
+	struct Out {std::ostream &del, &ins, &man;};	// deletes, inserts & manifest lines
+
+	// groups' DELETEs, batched into an IN list while their table & key columns stay the same
+	class Deletes
+	{	std::ostream* out;
+		std::string table, cols;
+		size_t n;
+		public:
+		Deletes(std::ostream* o): out(o), n(0) {}
+		void add(std::string const& t, std::string const& identity)
+		{	size_t eq = identity.find('=');
+			if (n && (t != table || identity.compare(0, eq, cols))) flush();
+			if (eq == std::string::npos) {*out << "DELETE FROM " << t << " WHERE " << identity << ";\n"; return;}
+			if (!n)
+			{	table = t;
+				cols.assign(identity, 0, eq);
+				*out << "DELETE FROM " << table << " WHERE " << cols << " IN (";
+			}
+			else *out << ',';
+			out->write(identity.data()+eq+1, identity.size()-eq-1);
+			if (++n == 10000) flush();
+		}
+		void flush()
+		{	if (n) *out << ");\n";
+			n = 0;
+		}
+	};
+
+	// renumbered columns of tables numbered by route, the first one holding each route's range
+	// of rows, with which ID each takes: 0 for points, 1 for segments
+	struct Numbered {const char* table; std::vector<std::pair<const char*,int>> cols;};
+	static const std::vector<Numbered> numbered;
+	static unsigned int const id_offset = 1000000000;
+
+	bool complete;	// previous manifest read through to its end
+	std::unordered_map<std::string, std::unordered_map<uint64_t, Group>> old;	// by table & identity
+	std::unordered_map<std::string, uint64_t> old_schema, schema;		// by part of the .sql file
+	std::unordered_set<std::string> rendered;				// tables written this run
+	std::ofstream file, manifest;
+	std::stringstream inserts;	// held until everything that might collide with them is deleted or moved
+
+	static uint64_t key(std::string const& identity)
+	{	return hash_bytes(identity.data(), identity.size(), 0);
+	}
+	void read();
+	void finish(ElapsedTime*);
+};
+static SqlDelta delta;
+#ifdef threading_enabled
+std::atomic_uint sql_threads(1);
+#endif
+
+const std::vector<SqlDelta::Numbered> SqlDelta::numbered
+{	{"waypoints", {{"pointId", 0}}},
+	{"segments",  {{"segmentId", 1}, {"waypoint1", 0}, {"waypoint2", 0}}},
+	{"clinched",  {{"segmentId", 1}}}
+};
+
+void SqlDelta::read()
+{	if (!Args::deltasql) return;
+	complete = 0;
+	std::ifstream in(Args::databasename+".manifest");
+	std::string line;
+	while (getline(in, line))
+	{	if (line == "#end") {complete = 1; break;}
+		std::vector<std::string> f;
+		for (size_t l = 0, r = 0; r != std::string::npos; l = r+1)
+		{	r = line.find('\t', l);
+			f.emplace_back(line, l, r-l);
+		}
+		if (f[0] == "#schema" && f.size() == 3)
+			old_schema[f[1]] = strtoull(f[2].data(), 0, 16);
+		else if (f.size() == 3 || f.size() == 7)
+		{	Group& g = old[f[0]][key(f[2])];
+			g.hash = strtoull(f[1].data(), 0, 16);
+			g.state = UNSEEN;
+			for (int i = 0; i < 2; i++)
+			{	g.base[i]  = f.size() == 7 ? strtoul(f[3+2*i].data(), 0, 10) : 0;
+				g.count[i] = f.size() == 7 ? strtoul(f[4+2*i].data(), 0, 10) : 0;
+			}
+		}
+		else break;
+	}
+	file.open(Args::databasename+".delta.sql");
+	file << "SET FOREIGN_KEY_CHECKS=0;\nSTART TRANSACTION;\n";
+	manifest.open(Args::databasename+".manifest.tmp");
+}
+
+void SqlDelta::finish(ElapsedTime *et)
+{	if (!Args::deltasql) return;
+	bool usable = complete;
+	for (auto& s : schema)
+	{	auto o = old_schema.find(s.first);
+		if (o == old_schema.end() || o->second != s.second) usable = 0;
+	}
+
+	// groups gone since the last run, and tables not written this run,
+	// whose groups carry over to the new manifest as they were
+	std::ifstream in(Args::databasename+".manifest");
+	std::string line;
+	Deletes gone(&file);
+	while (getline(in, line) && line != "#end")
+	{	size_t t = line.find('\t');
+		std::string table(line, 0, t);
+		if (table == "#schema")
+		{	size_t p = line.find('\t', t+1);
+			if (!schema.count(line.substr(t+1, p-t-1))) manifest << line << '\n';
+			continue;
+		}
+		if (!rendered.count(table)) {manifest << line << '\n'; continue;}
+		size_t i = line.find('\t', t+1);
+		std::string identity(line, i+1, line.find('\t', i+1)-i-1);
+		if (old[table][key(identity)].state == UNSEEN
+		 && std::none_of(numbered.begin(), numbered.end(), [&](const Numbered& n){return table == n.table;}))
+			gone.add(table, identity);
+	}
+	gone.flush();
+	in.close();
+
+	// delete or move each numbered table's groups, in ranges
+	std::vector<const Numbered*> moved;
+	for (const Numbered& n : numbered)
+	{	if (!rendered.count(n.table)) continue;
+		int const s = n.cols[0].second;
+		std::vector<Group*> groups;
+		for (auto& g : old[n.table]) groups.push_back(&g.second);
+		sort(groups.begin(), groups.end(), [s](Group* a, Group* b){return a->base[s] < b->base[s];});
+		// how far a group moves, with INT64_MAX for deleting it
+		auto shift = [&](Group* g, int i) -> int64_t
+		{	return g->state == SAME ? int64_t(g->moved[i]) - g->base[i] : INT64_MAX;};
+		auto same_op = [&](Group* a, Group* b)
+		{	for (auto& c : n.cols) if (shift(a, c.second) != shift(b, c.second)) return false;
+			return true;
+		};
+		bool any = 0;
+		for (size_t i = 0, j; i < groups.size(); i = j)
+		{	unsigned int const first = groups[i]->base[s];
+			unsigned int last = first + groups[i]->count[s];
+			for (j = i+1; j < groups.size() && groups[j]->base[s] == last && same_op(groups[i], groups[j]); j++)
+				last += groups[j]->count[s];
+			if (last == first || std::all_of(n.cols.begin(), n.cols.end(), [&](const std::pair<const char*,int>& c)
+						{return shift(groups[i], c.second) == 0;}))
+				continue;
+			if (shift(groups[i], s) == INT64_MAX)
+				file << "DELETE FROM " << n.table << " WHERE ";
+			else {	file << "UPDATE " << n.table << " SET ";
+				for (auto& c : n.cols)
+				  file << (&c == n.cols.data() ? "" : ", ") << c.first << '=' << c.first << '+' << shift(groups[i], c.second)+id_offset;
+				file << " WHERE ";
+				any = 1;
+			     }
+			file << n.cols[0].first << " BETWEEN " << first << " AND " << last-1 << ";\n";
+		}
+		if (any) moved.push_back(&n);
+	}
+
+	if (inserts.tellp() > 0) file << inserts.rdbuf();
+	for (const Numbered* n : moved)
+	{	file << "UPDATE " << n->table << " SET ";
+		for (auto& c : n->cols)
+		  file << (&c == n->cols.data() ? "" : ", ") << c.first << '=' << c.first << '-' << id_offset;
+		file << " WHERE " << n->cols[0].first << ">=" << id_offset << ";\n";
+	}
+	file << "COMMIT;\nSET FOREIGN_KEY_CHECKS=1;\n";
+	file.close();
+
+	for (auto& s : schema)
+	{	char fstr[17];
+		*fmt::format_to(fstr, "{:016x}", s.second) = 0;
+		manifest << "#schema\t" << s.first << '\t' << fstr << '\n';
+	}
+	manifest << "#end\n";
+	manifest.close();
+	rename((Args::databasename+".manifest.tmp").data(), (Args::databasename+".manifest").data());
+	if (!usable)
+	{	remove((Args::databasename+".delta.sql").data());
+		std::cout << et->et() << "No manifest of the same tables from a previous run; skipping "
+			  << Args::databasename << ".delta.sql." << std::endl;
+	}
+}
+
+// Writes rows as the values of INSERT statements, or in bulk-load
+// mode, as lines of tab-separated values for LOAD DATA INFILE
+class SqlRows
+{	public:
+	struct Text {std::string const& str;};	// escaped for string literals
+	struct Bool {bool b;};			// unquoted TRUE or FALSE
+	struct Id {size_t id, base;};		// numbered in route order
+
+	private:
+	std::ostream& out;
+	const char* table;
+	bool first;
+	bool tsv;	// format of the current render
+	bool relative;	// Ids relative to their bases, for delta hashes
+	bool ids;	// current row has any
+
+	// delta SQL
+	SqlDelta::Out* diff;
+	SqlDelta::Deletes dels;
+	std::unordered_map<uint64_t, SqlDelta::Group>* old;
+	std::ostringstream line;
+	std::string identity;		// current group's WHERE condition
+	std::vector<std::string> group_rows;
+	uint64_t hash;
+	unsigned int base[2], count[2];
+	bool numbered;
+	size_t inserted;
+
+	template <class T> void value(std::ostream& o, T const& v) {o << v;}
+	void value(std::ostream& o, double d)
+	{	char fstr[32];
+		*fmt::format_to(fstr, "{}", d) = 0;
+		o << fstr;
+	}
+	void value(std::ostream& o, Text t)
+	{	if (!tsv) {o << double_quotes(t.str); return;}
+		for (char c : t.str)
+		  switch (c)
+		  {	case '\t': o << "\\t"; break;
+			case '\n': o << "\\n"; break;
+			default:   o << c;
+		  }
+	}
+	void value(std::ostream& o, Id i)
+	{	o << (relative ? i.id - i.base : i.id);
+		ids = 1;
+	}
+
+	void fields(std::ostream&, bool) {}
+	template <class T, class... R> void fields(std::ostream& o, bool sep, T const& v, R const&... rest)
+	{	if (tsv)
+		{	if (sep) o << '\t';
+			value(o, v);
+		} else {
+			o << (sep ? ",'" : "'");
+			value(o, v);
+			o << '\'';
+		}
+		fields(o, 1, rest...);
+	}
+	template <class... R> void fields(std::ostream& o, bool sep, Bool b, R const&... rest)
+	{	if (sep) o << (tsv ? '\t' : ',');
+		if (tsv) o << b.b;
+		else o << (b.b ? "TRUE" : "FALSE");
+		fields(o, 1, rest...);
+	}
+
+	void open(std::string&& where)
+	{	close();
+		identity = where;
+		group_rows.clear();
+		hash = 0;
+		numbered = 0;
+	}
+	void close()
+	{	if (identity.empty()) return;
+		SqlDelta::Group* g = 0;
+		if (old)
+		{	auto it = old->find(SqlDelta::key(identity));
+			if (it != old->end()) g = &it->second;
+		}
+		bool const same = g && g->hash == hash;
+		if (g)
+		{	g->state = same ? SqlDelta::SAME : SqlDelta::CHANGED;
+			g->moved[0] = base[0];
+			g->moved[1] = base[1];
+			if (!same && !numbered) dels.add(table, identity);
+		}
+		if (!same)
+		  for (std::string& r : group_rows)
+		  {	if (inserted % 10000) diff->ins << ',';
+			else diff->ins << "INSERT INTO " << table << " VALUES\n";
+			diff->ins << r << '\n';
+			if (++inserted % 10000 == 0) diff->ins << ";\n";
+		  }
+		char fstr[17];
+		*fmt::format_to(fstr, "{:016x}", hash) = 0;
+		diff->man << table << '\t' << fstr << '\t' << identity;
+		if (numbered) diff->man << '\t' << base[0] << '\t' << count[0] << '\t' << base[1] << '\t' << count[1];
+		diff->man << '\n';
+		identity.clear();
+	}
+
+	public:
+	SqlRows(std::ostream& o, const char* t, SqlDelta::Out* d):
+		out(o), table(t), first(0), relative(0), diff(d), dels(d ? &d->del : 0), old(0), inserted(0)
+	{	auto it = delta.old.find(table);
+		if (diff && it != delta.old.end()) old = &it->second;
+	}
+
+	void insert(const char* table)
+	{	if (!Args::bulkload) out << "INSERT INTO " << table << " VALUES\n";
+		first = 1;
+	}
+	void end()
+	{	if (!Args::bulkload) out << ";\n";
+	}
+	template <class... T> void row(T const&... v)
+	{	tsv = Args::bulkload;
+		if (tsv) {fields(out, 0, v...); out << '\n';}
+		else {	out << (first ? "(" : ",(");
+			fields(out, 0, v...);
+			out << ")\n";
+		     }
+		first = 0;
+		if (identity.empty()) return;
+		tsv = ids = 0;
+		line.str(std::string());
+		line << '(';
+		fields(line, 0, v...);
+		line << ')';
+		std::string text = line.str();
+		if (ids)
+		{	relative = 1;
+			line.str(std::string());
+			fields(line, 0, v...);
+			relative = 0;
+		}
+		std::string const& h = ids ? line.str() : text;
+		hash = hash_bytes(h.data(), h.size(), hash);
+		// no use for the rows themselves without a previous manifest
+		if (delta.complete) group_rows.push_back(std::move(text));
+	}
+
+	// delta SQL groups of rows, compared, deleted & inserted together
+	void group()
+	{	if (diff) open("TRUE");
+	}
+	void group(const char* col, std::string const& v)
+	{	if (diff) open(std::string(col)+"='"+double_quotes(v)+'\'');
+	}
+	void group(const char* col1, std::string const& v1, const char* col2, std::string const& v2)
+	{	if (diff) open(std::string("(")+col1+','+col2+")=('"+double_quotes(v1)+"','"+double_quotes(v2)+"')");
+	}
+	void group(Route& r, size_t point_base, size_t segment_base)
+	{	if (!diff) return;
+		open("root='"+double_quotes(r.root)+'\'');
+		numbered = 1;
+		base[0] = point_base;	count[0] = r.points.size;
+		base[1] = segment_base;	count[1] = r.segments.size;
+	}
+	void finish()
+	{	if (!diff) return;
+		close();
+		dels.flush();
+		if (inserted % 10000) diff->ins << ";\n";
+	}
+};
+
+// Each table, or chunk of a large table, is rendered by a function into its own
+// buffer, in parallel when threading is enabled, and written out in order.
+// In bulk-load mode, the .sql file gets only the DROP & CREATE statements;
+// each table's rows go to a tab-separated data file of their own, loaded by
+// a .load.sql script that then builds the indexes.
+class SqlPieces
+{	struct Piece
+	{	std::ostream* file;
+		std::function<void(std::ostream&)> render;
+		std::function<void(SqlRows&)> rows;
+		const char* table;	// for rows
+		bool schema;		// part of what the delta manifest checks is unchanged
+	};
+	struct Text {std::stringstream text, del, ins, man;};
+	std::string part;	// of the .sql file, whose schema the delta manifest records
+	std::ofstream sqlfile, loadfile;
+	std::list<std::ofstream> datafiles;
+	std::vector<Piece> pieces;
+	std::string table;	// whose data file is datafiles.back()
+
+	void render(Piece& piece, Text& t)
+	{	if (!piece.table) return piece.render(t.text);
+		SqlDelta::Out out{t.del, t.ins, t.man};
+		SqlRows rows(t.text, piece.table, Args::deltasql ? &out : 0);
+		piece.rows(rows);
+		rows.finish();
+	}
+	void put(Piece& piece, Text& t)
+	{	if (t.text.tellp() > 0)
+		{	if (Args::deltasql && piece.schema)
+			{	std::string s = t.text.str();
+				delta.schema[part] = hash_bytes(s.data(), s.size(), delta.schema[part]);
+			}
+			*piece.file << t.text.rdbuf();
+		}
+		if (t.del.tellp() > 0) delta.file	<< t.del.rdbuf();
+		if (t.ins.tellp() > 0) delta.inserts	<< t.ins.rdbuf();
+		if (t.man.tellp() > 0) delta.manifest	<< t.man.rdbuf();
+	}
+
+	public:
+	SqlPieces(const char* p, std::ios::openmode mode): part(p), sqlfile(Args::databasename+".sql", mode)
+	{	if (Args::bulkload) loadfile.open(Args::databasename+".load.sql", mode);
+	}
+
+	// DROP & CREATE TABLE statements
+	void schema(std::function<void(std::ostream&)> render)
+	{	pieces.push_back({&sqlfile, render, 0, 0, 1});
+	}
+
+	// a table's rows, or a chunk thereof
+	void rows(const char* t, std::function<void(SqlRows&)> render)
+	{	if (Args::deltasql) delta.rendered.insert(t);
+		if (!Args::bulkload) return pieces.push_back({&sqlfile, 0, render, t, 0});
+		if (table != t)
+		{	table = t;
+			std::string filename = Args::databasename+'.'+table+".tsv";
+			datafiles.emplace_back(filename);
+			pieces.push_back({&loadfile, [filename, t](std::ostream& load)
+			{	load << "LOAD DATA LOCAL INFILE '" << double_quotes(filename) << "' INTO TABLE " << t << ";\n";
+			}, 0, 0, 0});
+		}
+		pieces.push_back({&datafiles.back(), 0, render, t, 0});
+	}
+
+	// indexes, built once the data they cover are in place
+	void indexes(std::function<void(std::ostream&)> render)
+	{	pieces.push_back({Args::bulkload ? &loadfile : &sqlfile, render, 0, 0, 1});
+	}
+
+	void write()
+	{
+	      #ifdef threading_enabled
+		// workers may run up to 2 pieces per thread ahead of the writer
+		size_t const lookahead = 2*Args::numthreads;
+		std::vector<Text> text(pieces.size());
+		std::vector<char> done(pieces.size(), 0);
+		size_t next = 0, written = 0;
+		std::mutex mtx;
+		std::condition_variable cv;
+		auto worker = [&]()
+		{	std::unique_lock<std::mutex> lock(mtx);
+			while (next < pieces.size())
+			{	size_t const p = next++;
+				cv.wait(lock, [&]{return p < written+lookahead;});
+				lock.unlock();
+				render(pieces[p], text[p]);
+				lock.lock();
+				done[p] = 1;
+				cv.notify_all();
+			}
+		};
+		// start workers as sql_threads allows, checking again as each piece is written
+		std::vector<std::thread> thr;
+		for (size_t p = 0; p < pieces.size(); p++)
+		{	while (thr.size() < std::min(sql_threads.load(), unsigned(Args::numthreads)))
+				thr.emplace_back(worker);
+			std::unique_lock<std::mutex> lock(mtx);
+			cv.wait(lock, [&]{return done[p];});
+			lock.unlock();
+			put(pieces[p], text[p]);
+			text[p] = Text();
+			lock.lock();
+			written++;
+			cv.notify_all();
+		}
+		for (std::thread& t : thr) t.join();
+	      #else
+		for (Piece& piece : pieces)
+		  if (piece.table)
+		  {	SqlDelta::Out out{delta.file, delta.inserts, delta.manifest};
+			SqlRows rows(*piece.file, piece.table, Args::deltasql ? &out : 0);
+			piece.rows(rows);
+			rows.finish();
+		  }
+		  else if (Args::deltasql)
+		  {	Text t;
+			piece.render(t.text);
+			put(piece, t);
+		  }
+		  else	piece.render(*piece.file);
+	      #endif
+	}
+};
+
+// Split routes into chunks of roughly equal weight, for rendering in parallel.
+// Returns indices into routes; each chunk runs from one index to the next.
+static std::vector<size_t> route_chunks(std::vector<size_t>& weight_offset, size_t chunks = 4*Args::numthreads)
+{	size_t const routes = weight_offset.size()-1;
+	std::vector<size_t> bounds(1, 0);
+	for (size_t c = 1, r = 0; c < chunks; c++)
+	{	size_t const target = weight_offset.back()*c/chunks;
+		while (r < routes && weight_offset[r] < target) r++;
+		if (r > bounds.back()) bounds.push_back(r);
+	}
+	bounds.push_back(routes);
+	return bounds;
+}
+
+// a latitude or longitude, with ".0" on whole numbers
+static const char* coord(char* fstr, double d)
+{	char* end = fmt::format_to(fstr, "{:.15}", d);
+	if (d == int(d)) {*end++ = '.'; *end++ = '0';}
+	*end = 0;
+	return fstr;
+}
 
 void sqlfile1
     (	ElapsedTime *et,
 	std::list<std::string*> *updates,
 	std::list<std::string*> *systemupdates,
 	std::mutex* term_mtx
-    ){	char fstr[65];
-	// Once all data is read in and processed, create a .sql file that will
+    ){	// Once all data is read in and processed, create a .sql file that will
 	// create all of the DB tables to be used by other parts of the project
-	std::ofstream sqlfile(Args::databasename+".sql");
-	// Note: removed "USE" line, DB name must be specified on the mysql command line
-
-	// we have to drop tables in the right order to avoid foreign key errors
-	sqlfile << "DROP TABLE IF EXISTS datacheckErrors;\n";
-	sqlfile << "DROP TABLE IF EXISTS clinchedConnectedRoutes;\n";
-	sqlfile << "DROP TABLE IF EXISTS clinchedRoutes;\n";
-	sqlfile << "DROP TABLE IF EXISTS clinchedOverallMileageByRegion;\n";
-	sqlfile << "DROP TABLE IF EXISTS clinchedSystemMileageByRegion;\n";
-	sqlfile << "DROP TABLE IF EXISTS listEntries;\n";
-	sqlfile << "DROP TABLE IF EXISTS overallMileageByRegion;\n";
-	sqlfile << "DROP TABLE IF EXISTS systemMileageByRegion;\n";
-	sqlfile << "DROP TABLE IF EXISTS clinched;\n";
-	sqlfile << "DROP TABLE IF EXISTS segments;\n";
-	sqlfile << "DROP TABLE IF EXISTS waypoints;\n";
-	sqlfile << "DROP TABLE IF EXISTS connectedRouteRoots;\n";
-	sqlfile << "DROP TABLE IF EXISTS connectedRoutes;\n";
-	sqlfile << "DROP TABLE IF EXISTS routes;\n";
-	sqlfile << "DROP TABLE IF EXISTS systems;\n";
-	sqlfile << "DROP TABLE IF EXISTS updates;\n";
-	sqlfile << "DROP TABLE IF EXISTS systemUpdates;\n";
-	sqlfile << "DROP TABLE IF EXISTS regions;\n";
-	sqlfile << "DROP TABLE IF EXISTS countries;\n";
-	sqlfile << "DROP TABLE IF EXISTS continents;\n";
-
-	// first, continents, countries, and regions
-      #ifndef threading_enabled
-	std::cout << et->et() << "...continents, countries, regions" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE continents (code VARCHAR(" << DBFieldLength::continentCode
-		<< "), name VARCHAR(" << DBFieldLength::continentName
-		<< "), PRIMARY KEY(code));\n";
-	sqlfile << "INSERT INTO continents VALUES\n";
-	bool first = 1;
-	for (size_t c = 0; c < Region::continents.size()-1; c++)
-	{	if (!first) sqlfile << ',';
-		first = 0;
-		sqlfile << "('" << Region::continents[c].first << "','" << Region::continents[c].second << "')\n";
-	}
-	sqlfile << ";\n";
+	delta.read();
+	SqlPieces sql("tables", std::ios::out);
+	typedef SqlRows::Text Text;
+	typedef SqlRows::Id Id;
 
-	sqlfile << "CREATE TABLE countries (code VARCHAR(" << DBFieldLength::countryCode
-		<< "), name VARCHAR(" << DBFieldLength::countryName
-		<< "), PRIMARY KEY(code));\n";
-	sqlfile << "INSERT INTO countries VALUES\n";
-	first = 1;
-	for (size_t c = 0; c < Region::countries.size()-1; c++)
-	{	if (!first) sqlfile << ',';
-		first = 0;
-		sqlfile << "('" << Region::countries[c].first << "','" << double_quotes(Region::countries[c].second) << "')\n";
-	}
-	sqlfile << ";\n";
-
-	sqlfile << "CREATE TABLE regions (code VARCHAR(" << DBFieldLength::regionCode
-		<< "), name VARCHAR(" << DBFieldLength::regionName
-		<< "), country VARCHAR(" << DBFieldLength::countryCode
-		<< "), continent VARCHAR(" << DBFieldLength::continentCode
-		<< "), regiontype VARCHAR(" << DBFieldLength::regiontype
-		<< "), ";
-	sqlfile << "PRIMARY KEY(code), FOREIGN KEY (country) REFERENCES countries(code), FOREIGN KEY (continent) REFERENCES continents(code));\n";
-	sqlfile << "INSERT INTO regions VALUES\n";
-	first = 1;
-	for (Region *r = Region::allregions.data, *dummy = Region::allregions.end()-1; r < dummy; r++)
-	{	if (!first) sqlfile << ',';
-		first = 0;
-		sqlfile << "('" << r->code << "','" << double_quotes(r->name)
-			<< "','" << r->country_code() << "','" << r->continent_code()
-			<< "','" << r->type << "')\n";
+	// routes in order, and where each one's points, segments & clinched rows start
+	std::vector<Route*> routes;
+	for (HighwaySystem& h : HighwaySystem::syslist)
+	  for (Route& r : h.routes)
+	    routes.push_back(&r);
+	std::vector<size_t> point_offset(1, 0), segment_offset(1, 0), clinched_offset(1, 0);
+	for (Route* r : routes)
+	{	size_t clinched = clinched_offset.back();
+		for (HighwaySegment& s : r->segments)
+		  for (size_t u = 0; u < s.clinched_by.num_units(); u++)
+		    clinched += __builtin_popcount(s.clinched_by.get_unit(u));
+		point_offset.push_back(point_offset.back() + r->points.size);
+		segment_offset.push_back(segment_offset.back() + r->segments.size);
+		clinched_offset.push_back(clinched);
 	}
-	sqlfile << ";\n";
+
+	sql.schema([&](std::ostream& sqlfile)
+	{	// Note: removed "USE" line, DB name must be specified on the mysql command line
+
+		// we have to drop tables in the right order to avoid foreign key errors
+		sqlfile << "DROP TABLE IF EXISTS datacheckErrors;\n";
+		sqlfile << "DROP TABLE IF EXISTS clinchedConnectedRoutes;\n";
+		sqlfile << "DROP TABLE IF EXISTS clinchedRoutes;\n";
+		sqlfile << "DROP TABLE IF EXISTS clinchedOverallMileageByRegion;\n";
+		sqlfile << "DROP TABLE IF EXISTS clinchedSystemMileageByRegion;\n";
+		sqlfile << "DROP TABLE IF EXISTS listEntries;\n";
+		sqlfile << "DROP TABLE IF EXISTS overallMileageByRegion;\n";
+		sqlfile << "DROP TABLE IF EXISTS systemMileageByRegion;\n";
+		sqlfile << "DROP TABLE IF EXISTS clinched;\n";
+		sqlfile << "DROP TABLE IF EXISTS segments;\n";
+		sqlfile << "DROP TABLE IF EXISTS waypoints;\n";
+		sqlfile << "DROP TABLE IF EXISTS connectedRouteRoots;\n";
+		sqlfile << "DROP TABLE IF EXISTS connectedRoutes;\n";
+		sqlfile << "DROP TABLE IF EXISTS routes;\n";
+		sqlfile << "DROP TABLE IF EXISTS systems;\n";
+		sqlfile << "DROP TABLE IF EXISTS updates;\n";
+		sqlfile << "DROP TABLE IF EXISTS systemUpdates;\n";
+		sqlfile << "DROP TABLE IF EXISTS regions;\n";
+		sqlfile << "DROP TABLE IF EXISTS countries;\n";
+		sqlfile << "DROP TABLE IF EXISTS continents;\n";
+
+		// first, continents, countries, and regions
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...continents, countries, regions" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE continents (code VARCHAR(" << DBFieldLength::continentCode
+			<< "), name VARCHAR(" << DBFieldLength::continentName
+			<< "), PRIMARY KEY(code));\n";
+	});
+	sql.rows("continents", [&](SqlRows& rows)
+	{	rows.group();
+		rows.insert("continents");
+		for (size_t c = 0; c < Region::continents.size()-1; c++)
+			rows.row(Region::continents[c].first, Region::continents[c].second);
+		rows.end();
+	});
+
+	sql.schema([&](std::ostream& sqlfile)
+	{	sqlfile << "CREATE TABLE countries (code VARCHAR(" << DBFieldLength::countryCode
+			<< "), name VARCHAR(" << DBFieldLength::countryName
+			<< "), PRIMARY KEY(code));\n";
+	});
+	sql.rows("countries", [&](SqlRows& rows)
+	{	rows.group();
+		rows.insert("countries");
+		for (size_t c = 0; c < Region::countries.size()-1; c++)
+			rows.row(Region::countries[c].first, Text{Region::countries[c].second});
+		rows.end();
+	});
+
+	sql.schema([&](std::ostream& sqlfile)
+	{	sqlfile << "CREATE TABLE regions (code VARCHAR(" << DBFieldLength::regionCode
+			<< "), name VARCHAR(" << DBFieldLength::regionName
+			<< "), country VARCHAR(" << DBFieldLength::countryCode
+			<< "), continent VARCHAR(" << DBFieldLength::continentCode
+			<< "), regiontype VARCHAR(" << DBFieldLength::regiontype
+			<< "), ";
+		sqlfile << "PRIMARY KEY(code), FOREIGN KEY (country) REFERENCES countries(code), FOREIGN KEY (continent) REFERENCES continents(code));\n";
+	});
+	sql.rows("regions", [&](SqlRows& rows)
+	{	rows.group();
+		rows.insert("regions");
+		for (Region *r = Region::allregions.data, *dummy = Region::allregions.end()-1; r < dummy; r++)
+			rows.row(r->code, Text{r->name}, r->country_code(), r->continent_code(), r->type);
+		rows.end();
+	});
 
 	// next, a table of the systems, consisting of the system name in the
 	// field 'name', the system's country code, its full name, the default
 	// color for its mapping, a level (one of active, preview, devel), and
 	// a boolean indicating if the system is active for mapping in the
 	// project in the field 'active'
-      #ifndef threading_enabled
-	std::cout << et->et() << "...systems" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE systems (systemName VARCHAR(" << DBFieldLength::systemName
-		<< "), countryCode CHAR(" << DBFieldLength::countryCode
-		<< "), fullName VARCHAR(" << DBFieldLength::systemFullName
-		<< "), color VARCHAR(" << DBFieldLength::color
-		<< "), level VARCHAR(" << DBFieldLength::level
-		<< "), tier INTEGER, csvOrder INTEGER, PRIMARY KEY(systemName));\n";
-	sqlfile << "INSERT INTO systems VALUES\n";
-	first = 1;
-	unsigned int csvOrder = 0;
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	{	if (!first) sqlfile << ',';
-		first = 0;
-		sqlfile << "('" << h.systemname << "','" << h.country->first << "','"
-			<< double_quotes(h.fullname) << "','" << h.color << "','" << h.level_name()
-			<< "','" << h.tier << "','" << csvOrder << "')\n";
-		csvOrder += 1;
-	}
-	sqlfile << ";\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...systems" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE systems (systemName VARCHAR(" << DBFieldLength::systemName
+			<< "), countryCode CHAR(" << DBFieldLength::countryCode
+			<< "), fullName VARCHAR(" << DBFieldLength::systemFullName
+			<< "), color VARCHAR(" << DBFieldLength::color
+			<< "), level VARCHAR(" << DBFieldLength::level
+			<< "), tier INTEGER, csvOrder INTEGER, PRIMARY KEY(systemName));\n";
+	});
+	sql.rows("systems", [&](SqlRows& rows)
+	{	rows.group();
+		rows.insert("systems");
+		unsigned int csvOrder = 0;
+		for (HighwaySystem& h : HighwaySystem::syslist)
+		{	rows.row(h.systemname, h.country->first, Text{h.fullname}, h.color, h.level_name(), h.tier, csvOrder);
+			csvOrder += 1;
+		}
+		rows.end();
+	});
 
 	// next, a table of highways, with the same fields as in the first line
-      #ifndef threading_enabled
-	std::cout << et->et() << "...routes" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE routes (systemName VARCHAR(" << DBFieldLength::systemName
-		<< "), region VARCHAR(" << DBFieldLength::regionCode
-		<< "), route VARCHAR(" << DBFieldLength::route
-		<< "), banner VARCHAR(" << DBFieldLength::banner
-		<< "), abbrev VARCHAR(" << DBFieldLength::abbrev
-		<< "), city VARCHAR(" << DBFieldLength::city
-		<< "), root VARCHAR(" << DBFieldLength::root
-		<< "), mileage FLOAT, rootOrder INTEGER, csvOrder INTEGER, PRIMARY KEY(root), FOREIGN KEY (systemName) REFERENCES systems(systemName));\n";
-	sqlfile << "INSERT INTO routes VALUES\n";
-	first = 1;
-	csvOrder = 0;
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	  for (Route& r : h.routes)
-	  {	if (!first) sqlfile << ',';
-		first = 0;
-		*fmt::format_to(fstr, "{}", r.mileage) = 0;
-		sqlfile << "('" << r.system->systemname << "','" << r.region->code << "','" << r.route << "','" << r.banner << "','" << r.abbrev
-			<< "','" << double_quotes(r.city) << "','" << r.root << "','" << fstr << "','" << r.rootOrder << "','" << csvOrder << "')\n";
-		csvOrder += 1;
-	  }
-	sqlfile << ";\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...routes" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE routes (systemName VARCHAR(" << DBFieldLength::systemName
+			<< "), region VARCHAR(" << DBFieldLength::regionCode
+			<< "), route VARCHAR(" << DBFieldLength::route
+			<< "), banner VARCHAR(" << DBFieldLength::banner
+			<< "), abbrev VARCHAR(" << DBFieldLength::abbrev
+			<< "), city VARCHAR(" << DBFieldLength::city
+			<< "), root VARCHAR(" << DBFieldLength::root
+			<< "), mileage FLOAT, rootOrder INTEGER, csvOrder INTEGER, PRIMARY KEY(root), FOREIGN KEY (systemName) REFERENCES systems(systemName));\n";
+	});
+	sql.rows("routes", [&](SqlRows& rows)
+	{	rows.insert("routes");
+		unsigned int csvOrder = 0;
+		for (Route* r : routes)
+		{	rows.group("root", r->root);
+			rows.row(r->system->systemname, r->region->code, r->route, r->banner, r->abbrev,
+				 Text{r->city}, r->root, r->mileage, r->rootOrder, csvOrder);
+			csvOrder += 1;
+		}
+		rows.end();
+	});
 
 	// connected routes table, but only first "root" in each in this table
-      #ifndef threading_enabled
-	std::cout << et->et() << "...connectedRoutes" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE connectedRoutes (systemName VARCHAR(" << DBFieldLength::systemName
-		<< "), route VARCHAR(" << DBFieldLength::route
-		<< "), banner VARCHAR(" << DBFieldLength::banner
-		<< "), groupName VARCHAR(" << DBFieldLength::city
-		<< "), firstRoot VARCHAR(" << DBFieldLength::root
-		<< "), mileage FLOAT, csvOrder INTEGER, PRIMARY KEY(firstRoot), FOREIGN KEY (firstRoot) REFERENCES routes(root));\n";
-	sqlfile << "INSERT INTO connectedRoutes VALUES\n";
-	first = 1;
-	csvOrder = 0;
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	  for (ConnectedRoute& cr : h.con_routes)
-	  {	if (!first) sqlfile << ',';
-		first = 0;
-		*fmt::format_to(fstr, "','{}'", cr.mileage) = 0;
-		sqlfile << "('" << cr.system->systemname << "','" << cr.route << "','" << cr.banner << "','" << double_quotes(cr.groupname)
-			<< "','" << (cr.roots.size() ? cr.roots[0]->root.data() : "ERROR_NO_ROOTS") << fstr << ",'" << csvOrder << "')\n";
-		csvOrder += 1;
-	  }
-	sqlfile << ";\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...connectedRoutes" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE connectedRoutes (systemName VARCHAR(" << DBFieldLength::systemName
+			<< "), route VARCHAR(" << DBFieldLength::route
+			<< "), banner VARCHAR(" << DBFieldLength::banner
+			<< "), groupName VARCHAR(" << DBFieldLength::city
+			<< "), firstRoot VARCHAR(" << DBFieldLength::root
+			<< "), mileage FLOAT, csvOrder INTEGER, PRIMARY KEY(firstRoot), FOREIGN KEY (firstRoot) REFERENCES routes(root));\n";
+	});
+	sql.rows("connectedRoutes", [&](SqlRows& rows)
+	{	rows.insert("connectedRoutes");
+		unsigned int csvOrder = 0;
+		for (HighwaySystem& h : HighwaySystem::syslist)
+		  for (ConnectedRoute& cr : h.con_routes)
+		  {	const char* first_root = cr.roots.size() ? cr.roots[0]->root.data() : "ERROR_NO_ROOTS";
+			rows.group("firstRoot", first_root);
+			rows.row(cr.system->systemname, cr.route, cr.banner, Text{cr.groupname}, first_root, cr.mileage, csvOrder);
+			csvOrder += 1;
+		  }
+		rows.end();
+	});
 
 	// This table has remaining roots for any connected route
 	// that connects multiple routes/roots
-      #ifndef threading_enabled
-	std::cout << et->et() << "...connectedRouteRoots" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE connectedRouteRoots (firstRoot VARCHAR(" << DBFieldLength::root
-		<< "), root VARCHAR(" << DBFieldLength::root
-		<< "), FOREIGN KEY (firstRoot) REFERENCES connectedRoutes(firstRoot));\n";
-	first = 1;
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	  for (ConnectedRoute& cr : h.con_routes)
-	    for (unsigned int i = 1; i < cr.roots.size(); i++)
-	    {	if (first) sqlfile << "INSERT INTO connectedRouteRoots VALUES\n";
-		else sqlfile << ',';
-		first = 0;
-		sqlfile << "('" << cr.roots[0]->root << "','" << cr.roots[i]->root << "')\n";
-	    }
-	sqlfile << ";\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...connectedRouteRoots" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE connectedRouteRoots (firstRoot VARCHAR(" << DBFieldLength::root
+			<< "), root VARCHAR(" << DBFieldLength::root
+			<< "), FOREIGN KEY (firstRoot) REFERENCES connectedRoutes(firstRoot));\n";
+	});
+	sql.rows("connectedRouteRoots", [&](SqlRows& rows)
+	{	bool first = 1;
+		for (HighwaySystem& h : HighwaySystem::syslist)
+		  for (ConnectedRoute& cr : h.con_routes)
+		  {	if (cr.roots.size() > 1) rows.group("firstRoot", cr.roots[0]->root);
+			for (unsigned int i = 1; i < cr.roots.size(); i++)
+			{	if (first) rows.insert("connectedRouteRoots");
+				first = 0;
+				rows.row(cr.roots[0]->root, cr.roots[i]->root);
+			}
+		  }
+		rows.end();
+	});
 
 	// Now, a table with raw highway route data: list of points, in order, that define the route
-      #ifndef threading_enabled
-	std::cout << et->et() << "...waypoints" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE waypoints (pointId INTEGER, pointName VARCHAR(" << DBFieldLength::label
-		<< "), latitude DOUBLE, longitude DOUBLE, root VARCHAR(" << DBFieldLength::root
-		<< "), PRIMARY KEY(pointId), FOREIGN KEY (root) REFERENCES routes(root));\n";
-	unsigned int point_num = 0;
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	  for (Route& r : h.routes)
-	  {	sqlfile << "INSERT INTO waypoints VALUES\n";
-		first = 1;
-		for (Waypoint& w : r.points)
-		{	if (!first) sqlfile << ',';
-			first = 0;
-			sqlfile << "('" << point_num << "','" << w.label;
-			*fmt::format_to(fstr,"','{:.15}",w.lat) = 0; sqlfile << fstr; if (w.lat==int(w.lat)) sqlfile << ".0";
-			*fmt::format_to(fstr,"','{:.15}",w.lng) = 0; sqlfile << fstr; if (w.lng==int(w.lng)) sqlfile << ".0";
-			sqlfile << "','" << r.root + "')\n";
-			point_num+=1;
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...waypoints" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE waypoints (pointId INTEGER, pointName VARCHAR(" << DBFieldLength::label
+			<< "), latitude DOUBLE, longitude DOUBLE, root VARCHAR(" << DBFieldLength::root
+			<< "), PRIMARY KEY(pointId), FOREIGN KEY (root) REFERENCES routes(root));\n";
+	});
+	std::vector<size_t> chunks = route_chunks(point_offset);
+	for (size_t c = 1; c < chunks.size(); c++)
+	  sql.rows("waypoints", [&, c](SqlRows& rows)
+	  {	char lat[32], lng[32];
+		for (size_t i = chunks[c-1]; i < chunks[c]; i++)
+		{	Route& r = *routes[i];
+			size_t point_num = point_offset[i];
+			rows.group(r, point_offset[i], segment_offset[i]);
+			rows.insert("waypoints");
+			for (Waypoint& w : r.points)
+			{	rows.row(Id{point_num, point_offset[i]}, w.label, coord(lat, w.lat), coord(lng, w.lng), r.root);
+				point_num+=1;
+			}
+			rows.end();
 		}
-		sqlfile << ";\n";
-	  }
-
-	// Build indices to speed latitude/longitude joins for intersecting highway queries
-	sqlfile << "CREATE INDEX `latitude` ON waypoints(`latitude`);\n";
-	sqlfile << "CREATE INDEX `longitude` ON waypoints(`longitude`);\n";
+	  });
 
-	// Table of all HighwaySegments.
-      #ifndef threading_enabled
-	std::cout << et->et() << "...segments" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE segments (segmentId INTEGER, waypoint1 INTEGER, waypoint2 INTEGER, root VARCHAR(" << DBFieldLength::root
-		<< "), PRIMARY KEY (segmentId), FOREIGN KEY (waypoint1) REFERENCES waypoints(pointId), "
-		<< "FOREIGN KEY (waypoint2) REFERENCES waypoints(pointId), FOREIGN KEY (root) REFERENCES routes(root));\n";
-	unsigned int segment_num = point_num = 0;
-	std::vector<std::pair<unsigned int, const char*>> clinched_list;
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	  for (Route& r : h.routes)
-	  {	sqlfile << "INSERT INTO segments VALUES\n";
-		first = 1;
-		for (HighwaySegment& s : r.segments)
-		{	if (!first) sqlfile << ',';
-			first = 0;
-			sqlfile << "('" << segment_num;
-			sqlfile	<< "','" << point_num++;
-			sqlfile	<< "','" << point_num;
-			sqlfile	<< "','" << r.root << "')\n";
-			for (TravelerList *t : s.clinched_by)
-			  clinched_list.emplace_back(segment_num, t->traveler_name.data());
-			segment_num += 1;
+	// Build indices to speed latitude/longitude joins for intersecting highway queries,
+	// then a table of all HighwaySegments.
+	sql.indexes([&](std::ostream& sqlfile)
+	{	sqlfile << "CREATE INDEX `latitude` ON waypoints(`latitude`);\n";
+		sqlfile << "CREATE INDEX `longitude` ON waypoints(`longitude`);\n";
+	});
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...segments" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE segments (segmentId INTEGER, waypoint1 INTEGER, waypoint2 INTEGER, root VARCHAR(" << DBFieldLength::root
+			<< "), PRIMARY KEY (segmentId), FOREIGN KEY (waypoint1) REFERENCES waypoints(pointId), "
+			<< "FOREIGN KEY (waypoint2) REFERENCES waypoints(pointId), FOREIGN KEY (root) REFERENCES routes(root));\n";
+	});
+	for (size_t c = 1; c < chunks.size(); c++)
+	  sql.rows("segments", [&, c](SqlRows& rows)
+	  {	for (size_t i = chunks[c-1]; i < chunks[c]; i++)
+		{	Route& r = *routes[i];
+			size_t segment_num = segment_offset[i];
+			size_t point_num = point_offset[i];
+			rows.group(r, point_offset[i], segment_offset[i]);
+			rows.insert("segments");
+			for (size_t s = 0; s < r.segments.size; s++)
+			{	rows.row(Id{segment_num, segment_offset[i]}, Id{point_num, point_offset[i]}, Id{point_num+1, point_offset[i]}, r.root);
+				point_num += 1;
+				segment_num += 1;
+			}
+			rows.end();
 		}
-		sqlfile << ";\n";
-		point_num++;
-	  }
+	  });
 
 	// maybe a separate traveler table will make sense but for now, I'll just use
 	// the name from the .list name
-      #ifndef threading_enabled
-	std::cout << et->et() << "...clinched" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE clinched (segmentId INTEGER, traveler VARCHAR(" << DBFieldLength::traveler
-		<< "), FOREIGN KEY (segmentId) REFERENCES segments(segmentId));\n";
-	for (size_t start = 0; start < clinched_list.size(); start += 10000)
-	{	sqlfile << "INSERT INTO clinched VALUES\n";
-		first = 1;
-		for (size_t c = start; c < start+10000 && c < clinched_list.size(); c++)
-		{	if (!first) sqlfile << ',';
-			first = 0;
-			sqlfile << "('" << clinched_list[c].first << "','" << clinched_list[c].second << "')\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...clinched" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE clinched (segmentId INTEGER, traveler VARCHAR(" << DBFieldLength::traveler
+			<< "), FOREIGN KEY (segmentId) REFERENCES segments(segmentId));\n";
+	});
+	// Rows are streamed straight from the segments' clinched_by bitsets,
+	// 10000 per INSERT, in pieces of 10000 rows, one INSERT apiece, split
+	// wherever in a route they fall. That keeps the buffered text small,
+	// however big the table or any one route's share of it gets.
+	// Delta SQL hashes & holds each route's rows as a group anyway;
+	// its pieces are cut between routes, about 10000 rows apiece.
+	std::vector<std::pair<size_t,size_t>> clinched_cuts; // route & row each piece starts at
+	if (Args::deltasql)
+	  for (size_t i : route_chunks(clinched_offset, std::max(4*size_t(Args::numthreads), clinched_offset.back()/10000)))
+	    clinched_cuts.emplace_back(i, clinched_offset[i]);
+	else {	for (size_t row = 0, i = 0; row < clinched_offset.back(); row += 10000)
+		{	while (clinched_offset[i+1] <= row) i++;
+			clinched_cuts.emplace_back(i, row);
 		}
-		sqlfile << ";\n";
-	}
+		clinched_cuts.emplace_back(routes.size(), clinched_offset.back());
+	     }
+	for (size_t c = 1; c < clinched_cuts.size(); c++)
+	  sql.rows("clinched", [&, c](SqlRows& rows)
+	  {	size_t row = clinched_cuts[c-1].second;
+		size_t const end_route = clinched_cuts[c].first, end = clinched_cuts[c].second;
+		for (size_t i = clinched_cuts[c-1].first; i < end_route || (i == end_route && row < end); i++)
+		{	size_t segment_num = segment_offset[i];
+			size_t r = clinched_offset[i]; // row number of each traveler's row
+			rows.group(*routes[i], point_offset[i], segment_offset[i]);
+			for (HighwaySegment& s : routes[i]->segments)
+			{	size_t const n = s.clinched_by.count();
+				if (r + n <= row)
+				{	// before this piece
+					r += n;
+					segment_num += 1;
+					continue;
+				}
+				for (TravelerList *t : s.clinched_by)
+				  if (r++ >= row)
+				  {	if (row == end) break;
+					if (row % 10000 == 0) rows.insert("clinched");
+					rows.row(Id{segment_num, segment_offset[i]}, t->traveler_name);
+					if (++row % 10000 == 0 || row == clinched_offset.back()) rows.end();
+				  }
+				if (row == end) break;
+				segment_num += 1;
+			}
+		}
+	  });
 
 	// overall mileage by region data (with concurrencies accounted for,
 	// active systems only then active+preview)
-      #ifndef threading_enabled
-	std::cout << et->et() << "...overallMileageByRegion" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE overallMileageByRegion (region VARCHAR(" << DBFieldLength::regionCode
-		<< "), activeMileage DOUBLE, activePreviewMileage DOUBLE);\n";
-	sqlfile << "INSERT INTO overallMileageByRegion VALUES\n";
-	first = 1;
-	for (Region& region : Region::allregions)
-	{	if (region.active_only_mileage+region.active_preview_mileage == 0) continue;
-		if (!first) sqlfile << ',';
-		first = 0;
-		*fmt::format_to(fstr, "','{}','{}')\n", region.active_only_mileage, region.active_preview_mileage) = 0;
-		sqlfile << "('" << region.code << fstr;
-	}
-	sqlfile << ";\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...overallMileageByRegion" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE overallMileageByRegion (region VARCHAR(" << DBFieldLength::regionCode
+			<< "), activeMileage DOUBLE, activePreviewMileage DOUBLE);\n";
+	});
+	sql.rows("overallMileageByRegion", [&](SqlRows& rows)
+	{	rows.group();
+		rows.insert("overallMileageByRegion");
+		for (Region& region : Region::allregions)
+		{	if (region.active_only_mileage+region.active_preview_mileage == 0) continue;
+			rows.row(region.code, region.active_only_mileage, region.active_preview_mileage);
+		}
+		rows.end();
+	});
 
 	// system mileage by region data (with concurrencies accounted for,
 	// active systems and preview systems only)
-      #ifndef threading_enabled
-	std::cout << et->et() << "...systemMileageByRegion" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE systemMileageByRegion (systemName VARCHAR(" << DBFieldLength::systemName
-		<< "), region VARCHAR(" << DBFieldLength::regionCode
-		<< "), mileage DOUBLE, FOREIGN KEY (systemName) REFERENCES systems(systemName));\n";
-	sqlfile << "INSERT INTO systemMileageByRegion VALUES\n";
-	first = 1;
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	  if (h.active_or_preview())
-	    for (std::pair<Region* const,double>& rm : h.mileage_by_region)
-	    {	if (!first) sqlfile << ',';
-		first = 0;
-		*fmt::format_to(fstr, "','{}')\n", rm.second) = 0;
-		sqlfile << "('" << h.systemname << "','" << rm.first->code << fstr;
-	    }
-	sqlfile << ";\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...systemMileageByRegion" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE systemMileageByRegion (systemName VARCHAR(" << DBFieldLength::systemName
+			<< "), region VARCHAR(" << DBFieldLength::regionCode
+			<< "), mileage DOUBLE, FOREIGN KEY (systemName) REFERENCES systems(systemName));\n";
+	});
+	sql.rows("systemMileageByRegion", [&](SqlRows& rows)
+	{	rows.group();
+		rows.insert("systemMileageByRegion");
+		for (HighwaySystem& h : HighwaySystem::syslist)
+		  if (h.active_or_preview())
+		    for (std::pair<Region* const,double>& rm : h.mileage_by_region)
+			rows.row(h.systemname, rm.first->code, rm.second);
+		rows.end();
+	});
 
 	// clinched overall mileage by region data (with concurrencies
 	// accounted for, active systems and preview systems only)
-      #ifndef threading_enabled
-	std::cout << et->et() << "...clinchedOverallMileageByRegion" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE clinchedOverallMileageByRegion (region VARCHAR(" << DBFieldLength::regionCode
-		<< "), traveler VARCHAR(" << DBFieldLength::traveler
-		<< "), activeMileage DOUBLE, activePreviewMileage DOUBLE);\n";
-	sqlfile << "INSERT INTO clinchedOverallMileageByRegion VALUES\n";
-	first = 1;
-	for (TravelerList& t : TravelerList::allusers)
-	  for (std::pair<Region* const,double>& rm : t.active_preview_mileage_by_region)
-	  {	if (!first) sqlfile << ',';
-		first = 0;
-		auto it = t.active_only_mileage_by_region.find(rm.first);
-		double active_miles = (it != t.active_only_mileage_by_region.end()) ? it->second : 0;
-		*fmt::format_to(fstr, "','{}','{}')\n", active_miles, rm.second) = 0;
-		sqlfile << "('" << rm.first->code << "','" << t.traveler_name << fstr;
-	  }
-	sqlfile << ";\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...clinchedOverallMileageByRegion" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE clinchedOverallMileageByRegion (region VARCHAR(" << DBFieldLength::regionCode
+			<< "), traveler VARCHAR(" << DBFieldLength::traveler
+			<< "), activeMileage DOUBLE, activePreviewMileage DOUBLE);\n";
+	});
+	sql.rows("clinchedOverallMileageByRegion", [&](SqlRows& rows)
+	{	rows.insert("clinchedOverallMileageByRegion");
+		for (TravelerList& t : TravelerList::allusers)
+		{	rows.group("traveler", t.traveler_name);
+			for (std::pair<Region* const,double>& rm : t.active_preview_mileage_by_region)
+			{	auto it = t.active_only_mileage_by_region.find(rm.first);
+				double active_miles = (it != t.active_only_mileage_by_region.end()) ? it->second : 0;
+				rows.row(rm.first->code, t.traveler_name, active_miles, rm.second);
+			}
+		}
+		rows.end();
+	});
 
 	// clinched system mileage by region data (with concurrencies accounted
 	// for, active systems and preview systems only)
-      #ifndef threading_enabled
-	std::cout << et->et() << "...clinchedSystemMileageByRegion" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE clinchedSystemMileageByRegion (systemName VARCHAR(" << DBFieldLength::systemName
-		<< "), region VARCHAR(" << DBFieldLength::regionCode
-		<< "), traveler VARCHAR(" << DBFieldLength::traveler
-		<< "), mileage DOUBLE, FOREIGN KEY (systemName) REFERENCES systems(systemName));\n";
-	sqlfile << "INSERT INTO clinchedSystemMileageByRegion VALUES\n";
-	first = 1;
-	for (TravelerList& t : TravelerList::allusers)
-	  for (auto& csmbr : t.system_region_mileages)
-	  {	auto& systemname = csmbr.first->systemname;
-		for (auto& rm : csmbr.second)
-		{	if (!first) sqlfile << ',';
-			first = 0;
-			*fmt::format_to(fstr, "{}", rm.second) = 0;
-			sqlfile << "('" << systemname << "','" << rm.first->code << "','" << t.traveler_name << "','" << fstr << "')\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...clinchedSystemMileageByRegion" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE clinchedSystemMileageByRegion (systemName VARCHAR(" << DBFieldLength::systemName
+			<< "), region VARCHAR(" << DBFieldLength::regionCode
+			<< "), traveler VARCHAR(" << DBFieldLength::traveler
+			<< "), mileage DOUBLE, FOREIGN KEY (systemName) REFERENCES systems(systemName));\n";
+	});
+	sql.rows("clinchedSystemMileageByRegion", [&](SqlRows& rows)
+	{	rows.insert("clinchedSystemMileageByRegion");
+		for (TravelerList& t : TravelerList::allusers)
+		{	rows.group("traveler", t.traveler_name);
+			for (auto& csmbr : t.system_region_mileages)
+			{	auto& systemname = csmbr.first->systemname;
+				for (auto& rm : csmbr.second)
+					rows.row(systemname, rm.first->code, t.traveler_name, rm.second);
+			}
 		}
-	  }
-	sqlfile << ";\n";
+		rows.end();
+	});
 
 	// clinched mileage by connected route, active systems and preview
-	// systems only
-      #ifndef threading_enabled
-	std::cout << et->et() << "...clinchedConnectedRoutes" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE clinchedConnectedRoutes (route VARCHAR(" << DBFieldLength::root
-		<< "), traveler VARCHAR(" << DBFieldLength::traveler
-		<< "), mileage FLOAT, clinched BOOLEAN, FOREIGN KEY (route) REFERENCES connectedRoutes(firstRoot));\n";
-	for (TravelerList& t : TravelerList::allusers)
-	{	if (t.ccr_values.empty()) continue;
-		sqlfile << "INSERT INTO clinchedConnectedRoutes VALUES\n";
-		first = 1;
-		for (auto& rm : t.ccr_values)
-		{	if (!first) sqlfile << ',';
-			first = 0;
-			*fmt::format_to(fstr, "{}", rm.second) = 0;
-			sqlfile << "('" << rm.first->roots[0]->root << "','" << t.traveler_name << "','"
-				<< fstr << "','" << (rm.second == rm.first->mileage) << "')\n";
+	// systems only, and by route, in chunks of travelers
+	size_t const traveler_chunks = std::min(4*size_t(Args::numthreads), TravelerList::allusers.size);
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...clinchedConnectedRoutes" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE clinchedConnectedRoutes (route VARCHAR(" << DBFieldLength::root
+			<< "), traveler VARCHAR(" << DBFieldLength::traveler
+			<< "), mileage FLOAT, clinched BOOLEAN, FOREIGN KEY (route) REFERENCES connectedRoutes(firstRoot));\n";
+	});
+	for (size_t c = 0; c < traveler_chunks; c++)
+	  sql.rows("clinchedConnectedRoutes", [&, c](SqlRows& rows)
+	  {	for (TravelerList *t = TravelerList::allusers.data + c*TravelerList::allusers.size/traveler_chunks,
+				*end = TravelerList::allusers.data + (c+1)*TravelerList::allusers.size/traveler_chunks; t < end; t++)
+		{	if (t->ccr_values.empty()) continue;
+			rows.insert("clinchedConnectedRoutes");
+			for (auto& rm : t->ccr_values)
+			{	rows.group("route", rm.first->roots[0]->root, "traveler", t->traveler_name);
+				rows.row(rm.first->roots[0]->root, t->traveler_name, rm.second, rm.second == rm.first->mileage);
+			}
+			rows.end();
 		}
-		sqlfile << ";\n";
-	}
-
-	// clinched mileage by route, active systems and preview systems only
-      #ifndef threading_enabled
-	std::cout << et->et() << "...clinchedRoutes" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE clinchedRoutes (route VARCHAR(" << DBFieldLength::root
-		<< "), traveler VARCHAR(" << DBFieldLength::traveler
-		<< "), mileage FLOAT, clinched BOOLEAN, FOREIGN KEY (route) REFERENCES routes(root));\n";
-	for (TravelerList& t : TravelerList::allusers)
-	{	if (t.cr_values.empty()) continue;
-		sqlfile << "INSERT INTO clinchedRoutes VALUES\n";
-		first = 1;
-		for (std::pair<Route*,double>& rm : t.cr_values)
-		{	if (!first) sqlfile << ',';
-			first = 0;
-			*fmt::format_to(fstr, "{}", rm.second) = 0;
-			sqlfile << "('" << rm.first->root << "','" << t.traveler_name << "','"
-				<< fstr << "','" << (rm.second >= rm.first->mileage) << "')\n";
+	  });
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...clinchedRoutes" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE clinchedRoutes (route VARCHAR(" << DBFieldLength::root
+			<< "), traveler VARCHAR(" << DBFieldLength::traveler
+			<< "), mileage FLOAT, clinched BOOLEAN, FOREIGN KEY (route) REFERENCES routes(root));\n";
+	});
+	for (size_t c = 0; c < traveler_chunks; c++)
+	  sql.rows("clinchedRoutes", [&, c](SqlRows& rows)
+	  {	for (TravelerList *t = TravelerList::allusers.data + c*TravelerList::allusers.size/traveler_chunks,
+				*end = TravelerList::allusers.data + (c+1)*TravelerList::allusers.size/traveler_chunks; t < end; t++)
+		{	if (t->cr_values.empty()) continue;
+			rows.insert("clinchedRoutes");
+			for (std::pair<Route*,double>& rm : t->cr_values)
+			{	rows.group("route", rm.first->root, "traveler", t->traveler_name);
+				rows.row(rm.first->root, t->traveler_name, rm.second, rm.second >= rm.first->mileage);
+			}
+			rows.end();
 		}
-		sqlfile << ";\n";
-	}
+	  });
 
 	// list entries
-	  #ifndef threading_enabled
-	std::cout << et->et() << "...listEntries" << std::endl;
-	  #endif
-	sqlfile << "CREATE TABLE listEntries (traveler VARCHAR(" << DBFieldLength::traveler
-		<< "), description VARCHAR(" << DBFieldLength::listDescription
-		<< "), includeInRanks BOOLEAN);\n";
-	sqlfile << "INSERT INTO listEntries VALUES\n";
-	first = 1;
-	for (TravelerList& t : TravelerList::allusers)
-	{	if (!first) sqlfile << ',';
-		first = 0;
-		// look for this traveler in the listinfo map
-		auto it = TravelerList::listinfo.find(t.traveler_name);
-		// if found, use the description and includeInRanks values from the map
-		if (it != TravelerList::listinfo.end())
-		{	sqlfile << "('" << t.traveler_name << "','" << double_quotes(it->second[0]) << "'," << (it->second[1] == "1" ? "TRUE" : "FALSE") << ")\n";
-		    // remove it from the map
-			TravelerList::listinfo.erase(it);
-		}
-		else 
-		{   // use the defaults
-			sqlfile << "('" << t.traveler_name << "','" << double_quotes(TravelerList::defaults[0]) << "'," << (TravelerList::defaults[1] == "1" ? "TRUE" : "FALSE") << ")\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...listEntries" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE listEntries (traveler VARCHAR(" << DBFieldLength::traveler
+			<< "), description VARCHAR(" << DBFieldLength::listDescription
+			<< "), includeInRanks BOOLEAN);\n";
+	});
+	sql.rows("listEntries", [&](SqlRows& rows)
+	{	rows.group();
+		rows.insert("listEntries");
+		for (TravelerList& t : TravelerList::allusers)
+		{	// look for this traveler in the listinfo map
+			auto it = TravelerList::listinfo.find(t.traveler_name);
+			// if found, use the description and includeInRanks values from the map
+			if (it != TravelerList::listinfo.end())
+			{	rows.row(t.traveler_name, Text{it->second[0]}, SqlRows::Bool{it->second[1] == "1"});
+			    // remove it from the map
+				TravelerList::listinfo.erase(it);
+			}
+			else 
+			{   // use the defaults
+				rows.row(t.traveler_name, Text{TravelerList::defaults[0]}, SqlRows::Bool{TravelerList::defaults[1] == "1"});
+			}
 		}
-	}
-	sqlfile << ";\n";
+		rows.end();
 
-	// report any remaining entries in the listinfo map as errors (TODO)
+		// report any remaining entries in the listinfo map as errors (TODO)
+	});
 
 	// create indexes for some tables to improve query performance
-	sqlfile << "DROP INDEX IF EXISTS idx_com_region_traveler ON clinchedOverallMileageByRegion;\n";
-	sqlfile << "DROP INDEX IF EXISTS idx_le_traveler_includeInRanks ON listEntries;\n"; 
-	sqlfile << "DROP INDEX IF EXISTS idx_routes_region_systemName ON routes;\n";
-	sqlfile << "DROP INDEX IF EXISTS idx_cr_route_traveler ON clinchedRoutes;\n";
-	sqlfile << "DROP INDEX IF EXISTS idx_systems_systemName ON systems;\n";
-	sqlfile << "CREATE INDEX idx_com_region_traveler ON clinchedOverallMileageByRegion (region, traveler);\n";
-	sqlfile << "CREATE INDEX idx_le_traveler_includeInRanks ON listEntries (traveler, includeInRanks);\n"; 
-	sqlfile << "CREATE INDEX idx_routes_region_systemName ON routes (region, systemName);\n";
-	sqlfile << "CREATE INDEX idx_cr_route_traveler ON clinchedRoutes (route, traveler);\n";
-	sqlfile << "CREATE INDEX idx_systems_systemName ON systems (systemName);\n";
+	sql.indexes([&](std::ostream& sqlfile)
+	{	sqlfile << "DROP INDEX IF EXISTS idx_com_region_traveler ON clinchedOverallMileageByRegion;\n";
+		sqlfile << "DROP INDEX IF EXISTS idx_le_traveler_includeInRanks ON listEntries;\n"; 
+		sqlfile << "DROP INDEX IF EXISTS idx_routes_region_systemName ON routes;\n";
+		sqlfile << "DROP INDEX IF EXISTS idx_cr_route_traveler ON clinchedRoutes;\n";
+		sqlfile << "DROP INDEX IF EXISTS idx_systems_systemName ON systems;\n";
+		sqlfile << "CREATE INDEX idx_com_region_traveler ON clinchedOverallMileageByRegion (region, traveler);\n";
+		sqlfile << "CREATE INDEX idx_le_traveler_includeInRanks ON listEntries (traveler, includeInRanks);\n"; 
+		sqlfile << "CREATE INDEX idx_routes_region_systemName ON routes (region, systemName);\n";
+		sqlfile << "CREATE INDEX idx_cr_route_traveler ON clinchedRoutes (route, traveler);\n";
+		sqlfile << "CREATE INDEX idx_systems_systemName ON systems (systemName);\n";
+	});
 
 	// updates entries
-      #ifndef threading_enabled
-	std::cout << et->et() << "...updates" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE updates (date VARCHAR(" << DBFieldLength::date
-		<< "), region VARCHAR(" << DBFieldLength::countryRegion
-		<< "), route VARCHAR(" << DBFieldLength::routeLongName
-		<< "), root VARCHAR(" << DBFieldLength::root
-		<< "), description VARCHAR(" << DBFieldLength::updateText
-		<< "));\n";
-	if (updates->size())
-	{	sqlfile << "INSERT INTO updates VALUES\n";
-		first = 1;
-		for (std::string* &update : *updates)
-		{	if (!first) sqlfile << ',';
-			first = 0;
-			sqlfile << "('"  << update[0] << "','" << double_quotes(update[1]) << "','" << double_quotes(update[2])
-				<< "','" << update[3] << "','" << double_quotes(update[4]) << "')\n";
-			delete[] update;
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...updates" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE updates (date VARCHAR(" << DBFieldLength::date
+			<< "), region VARCHAR(" << DBFieldLength::countryRegion
+			<< "), route VARCHAR(" << DBFieldLength::routeLongName
+			<< "), root VARCHAR(" << DBFieldLength::root
+			<< "), description VARCHAR(" << DBFieldLength::updateText
+			<< "));\n";
+	});
+	sql.rows("updates", [&](SqlRows& rows)
+	{	rows.group();
+		if (updates->size())
+		{	rows.insert("updates");
+			for (std::string* &update : *updates)
+			{	rows.row(update[0], Text{update[1]}, Text{update[2]}, update[3], Text{update[4]});
+				delete[] update;
+			}
+			rows.end();
 		}
-		sqlfile << ";\n";
-	}
+	});
 
 	// systemUpdates entries
-      #ifndef threading_enabled
-	std::cout << et->et() << "...systemUpdates" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE systemUpdates (date VARCHAR(" << DBFieldLength::date
-		<< "), region VARCHAR(" << DBFieldLength::countryRegion
-		<< "), systemName VARCHAR(" << DBFieldLength::systemName
-		<< "), description VARCHAR(" << DBFieldLength::systemFullName
-		<< "), statusChange VARCHAR(" << DBFieldLength::statusChange
-		<< "));\n";
-	if (systemupdates->size())
-	{	sqlfile << "INSERT INTO systemUpdates VALUES\n";
-		first = 1;
-		for (std::string* &systemupdate : *systemupdates)
-		{	if (!first) sqlfile << ',';
-			first = 0;
-			sqlfile << "('"  << systemupdate[0] << "','" << double_quotes(systemupdate[1])
-				<< "','" << systemupdate[2] << "','" << double_quotes(systemupdate[3]) << "','" << systemupdate[4] << "')\n";
-			delete[] systemupdate;
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...systemUpdates" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE systemUpdates (date VARCHAR(" << DBFieldLength::date
+			<< "), region VARCHAR(" << DBFieldLength::countryRegion
+			<< "), systemName VARCHAR(" << DBFieldLength::systemName
+			<< "), description VARCHAR(" << DBFieldLength::systemFullName
+			<< "), statusChange VARCHAR(" << DBFieldLength::statusChange
+			<< "));\n";
+	});
+	sql.rows("systemUpdates", [&](SqlRows& rows)
+	{	rows.group();
+		if (systemupdates->size())
+		{	rows.insert("systemUpdates");
+			for (std::string* &systemupdate : *systemupdates)
+			{	rows.row(systemupdate[0], Text{systemupdate[1]}, systemupdate[2], Text{systemupdate[3]}, systemupdate[4]);
+				delete[] systemupdate;
+			}
+			rows.end();
 		}
-		sqlfile << ";\n";
-	}
+	});
 
 	// datacheck errors into the db
-      #ifndef threading_enabled
-	std::cout << et->et() << "...datacheckErrors" << std::endl;
-      #endif
-	sqlfile << "CREATE TABLE datacheckErrors (route VARCHAR(" << DBFieldLength::root
-		<< "), label1 VARCHAR(" << DBFieldLength::label
-		<< "), label2 VARCHAR(" << DBFieldLength::label
-		<< "), label3 VARCHAR(" << DBFieldLength::label
-		<< "), code VARCHAR(" << DBFieldLength::dcErrCode
-		<< "), value VARCHAR(" << DBFieldLength::dcErrValue
-		<< "), falsePositive BOOLEAN, FOREIGN KEY (route) REFERENCES routes(root));\n";
-	if (Datacheck::errors.size())
-	{	sqlfile << "INSERT INTO datacheckErrors VALUES\n";
-		bool first = 1;
-		for (Datacheck &d : Datacheck::errors)
-		{	if (!first) sqlfile << ',';
-			first = 0;
-			sqlfile << "('" << d.route->root << "',";
-			sqlfile << "'"  << d.label1 << "','" << d.label2 << "','" << d.label3 << "',";
-			sqlfile << "'"  << d.code << "','" << d.info << "','" << int(d.fp) << "')\n";
+	sql.schema([&](std::ostream& sqlfile)
+	{
+	      #ifndef threading_enabled
+		std::cout << et->et() << "...datacheckErrors" << std::endl;
+	      #endif
+		sqlfile << "CREATE TABLE datacheckErrors (route VARCHAR(" << DBFieldLength::root
+			<< "), label1 VARCHAR(" << DBFieldLength::label
+			<< "), label2 VARCHAR(" << DBFieldLength::label
+			<< "), label3 VARCHAR(" << DBFieldLength::label
+			<< "), code VARCHAR(" << DBFieldLength::dcErrCode
+			<< "), value VARCHAR(" << DBFieldLength::dcErrValue
+			<< "), falsePositive BOOLEAN, FOREIGN KEY (route) REFERENCES routes(root));\n";
+	});
+	sql.rows("datacheckErrors", [&](SqlRows& rows)
+	{	rows.group();
+		if (Datacheck::errors.size())
+		{	rows.insert("datacheckErrors");
+			for (Datacheck &d : Datacheck::errors)
+				rows.row(d.route->root, *d.label1, *d.label2, *d.label3, Datacheck::codes[d.code], d.info(), int(d.fp));
 		}
-	}
-	sqlfile << ";\n";
-	sqlfile.close();
+		rows.end();
+	});
+
+	sql.write();
       #ifdef threading_enabled
 	term_mtx->lock();
 	std::cout << '\n' << et->et() << "Pause writing database file " << Args::databasename << ".sql.\n" << std::flush;
@@ -509,72 +1128,73 @@ void sqlfile1
      }
 
 void sqlfile2(ElapsedTime *et, std::list<std::array<std::string,3>> *graph_types)
-{	std::ofstream sqlfile(Args::databasename+".sql", std::ios::app);
+{	SqlPieces sql("graphs", std::ios::app);
 
 	// update graph info in DB if graphs were generated
 	if (!Args::skipgraphs)
-	{
-	      #ifndef threading_enabled
-		std::cout << et->et() << "...graphs" << std::endl;
-	      #endif
-		sqlfile << "DROP TABLE IF EXISTS graphArchives;\n";
-		sqlfile << "DROP TABLE IF EXISTS graphArchiveSets;\n";
-		sqlfile << "DROP TABLE IF EXISTS graphs;\n";
-		sqlfile << "DROP TABLE IF EXISTS graphTypes;\n";
-		sqlfile << "CREATE TABLE graphTypes (category VARCHAR(" << DBFieldLength::graphCategory
-			<< "), descr VARCHAR(" << DBFieldLength::graphDescr
-			<< "), longDescr TEXT, PRIMARY KEY(category));\n";
-		if (graph_types->size())
-		{	sqlfile << "INSERT INTO graphTypes VALUES\n";
-			bool first = 1;
-			for (std::array<std::string,3> &g : *graph_types)
-			{	if (!first) sqlfile << ',';
-				first = 0;
-				sqlfile << "('" << g[0] << "','" << g[1] << "','" << g[2] << "')\n";
+	{	sql.schema([&](std::ostream& sqlfile)
+		{
+		      #ifndef threading_enabled
+			std::cout << et->et() << "...graphs" << std::endl;
+		      #endif
+			sqlfile << "DROP TABLE IF EXISTS graphArchives;\n";
+			sqlfile << "DROP TABLE IF EXISTS graphArchiveSets;\n";
+			sqlfile << "DROP TABLE IF EXISTS graphs;\n";
+			sqlfile << "DROP TABLE IF EXISTS graphTypes;\n";
+			sqlfile << "CREATE TABLE graphTypes (category VARCHAR(" << DBFieldLength::graphCategory
+				<< "), descr VARCHAR(" << DBFieldLength::graphDescr
+				<< "), longDescr TEXT, PRIMARY KEY(category));\n";
+		});
+		sql.rows("graphTypes", [&](SqlRows& rows)
+		{	rows.group();
+			if (graph_types->size())
+			{	rows.insert("graphTypes");
+				for (std::array<std::string,3> &g : *graph_types)
+					rows.row(g[0], g[1], g[2]);
+				rows.end();
 			}
-			sqlfile << ";\n";
-		}
-		sqlfile << "CREATE TABLE graphs (filename VARCHAR(" << DBFieldLength::graphFilename
-			<< "), descr VARCHAR(" << DBFieldLength::graphDescr
-			<< "), vertices INTEGER, edges INTEGER, travelers INTEGER, "
-			<< "format VARCHAR(" << DBFieldLength::graphFormat
-			<< "), category VARCHAR(" << DBFieldLength::graphCategory
-			<< "), FOREIGN KEY (category) REFERENCES graphTypes(category));\n";
-		if (GraphListEntry::entries.size())
-		{	sqlfile << "INSERT INTO graphs VALUES\n";
-			for (size_t g = 0; g < GraphListEntry::entries.size(); g++)
-			{	if (g) sqlfile << ',';
-				#define G GraphListEntry::entries[g]
-				sqlfile << "('"  << G.filename() << "','" << double_quotes(G.descr)
-					<< "','" << G.vertices   << "','" << G.edges
-					<< "','" << G.travelers  << "','" << G.format()
-					<< "','" << G.category() << "')\n";
-				#undef G
+		});
+		sql.schema([&](std::ostream& sqlfile)
+		{	sqlfile << "CREATE TABLE graphs (filename VARCHAR(" << DBFieldLength::graphFilename
+				<< "), descr VARCHAR(" << DBFieldLength::graphDescr
+				<< "), vertices INTEGER, edges INTEGER, travelers INTEGER, "
+				<< "format VARCHAR(" << DBFieldLength::graphFormat
+				<< "), category VARCHAR(" << DBFieldLength::graphCategory
+				<< "), FOREIGN KEY (category) REFERENCES graphTypes(category));\n";
+		});
+		sql.rows("graphs", [&](SqlRows& rows)
+		{	rows.group();
+			if (GraphListEntry::entries.size())
+			{	rows.insert("graphs");
+				for (GraphListEntry& g : GraphListEntry::entries)
+					rows.row(g.filename(), SqlRows::Text{g.descr}, g.vertices, g.edges, g.travelers, g.format(), g.category());
+				rows.end();
 			}
-			sqlfile << ";\n";
-		}
-		sqlfile << "CREATE TABLE graphArchiveSets (setName VARCHAR("
-			<< DBFieldLength::setName << "), descr VARCHAR("
-			<< DBFieldLength::graphDescr
-			<< "), dateStamp DATE, hwyDataVers VARCHAR("
-			<< DBFieldLength::gitCommit
-			<< "), userDataVers VARCHAR("
-			<< DBFieldLength::gitCommit 
-			<< "), dataProcVers VARCHAR("
-			<< DBFieldLength::gitCommit
-			<< "), PRIMARY KEY(setName));\n";
-		sqlfile << "CREATE TABLE graphArchives (filename VARCHAR("
-			<< DBFieldLength::graphFilename
-			<< "), descr VARCHAR("
-			<< DBFieldLength::graphDescr
-			<< "), vertices INTEGER, edges INTEGER, travelers INTEGER, format VARCHAR("
-			<< DBFieldLength::graphFormat
-			<< "), category VARCHAR("
-			<< DBFieldLength::graphCategory
-			<< "), setName VARCHAR("
-			<< DBFieldLength::setName
-			<< "), maxDegree INTEGER, avgDegree FLOAT, aspectRatio FLOAT, components INTEGER, FOREIGN KEY (category) REFERENCES graphTypes(category), FOREIGN KEY (setName) REFERENCES graphArchiveSets(setName));\n";
-	}
-
-	sqlfile.close();
+		});
+		sql.schema([&](std::ostream& sqlfile)
+		{	sqlfile << "CREATE TABLE graphArchiveSets (setName VARCHAR("
+				<< DBFieldLength::setName << "), descr VARCHAR("
+				<< DBFieldLength::graphDescr
+				<< "), dateStamp DATE, hwyDataVers VARCHAR("
+				<< DBFieldLength::gitCommit
+				<< "), userDataVers VARCHAR("
+				<< DBFieldLength::gitCommit 
+				<< "), dataProcVers VARCHAR("
+				<< DBFieldLength::gitCommit
+				<< "), PRIMARY KEY(setName));\n";
+			sqlfile << "CREATE TABLE graphArchives (filename VARCHAR("
+				<< DBFieldLength::graphFilename
+				<< "), descr VARCHAR("
+				<< DBFieldLength::graphDescr
+				<< "), vertices INTEGER, edges INTEGER, travelers INTEGER, format VARCHAR("
+				<< DBFieldLength::graphFormat
+				<< "), category VARCHAR("
+				<< DBFieldLength::graphCategory
+				<< "), setName VARCHAR("
+				<< DBFieldLength::setName
+				<< "), maxDegree INTEGER, avgDegree FLOAT, aspectRatio FLOAT, components INTEGER, FOREIGN KEY (category) REFERENCES graphTypes(category), FOREIGN KEY (setName) REFERENCES graphArchiveSets(setName));\n";
+		});
+		sql.write();
+	}
+	delta.finish(et);
 }
@@ -2,6 +2,12 @@ class ElapsedTime;
 #include <array>
 #include <list>
 #include <mutex>
+#ifdef threading_enabled
+#include <atomic>
+
+// threads that may render .sql pieces; fewer while graph generation keeps the rest busy
+extern std::atomic_uint sql_threads;
+#endif
 
 void sqlfile1
 (	ElapsedTime*,
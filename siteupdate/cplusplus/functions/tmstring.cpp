@@ -84,3 +84,17 @@ std::string double_quotes(std::string str)
 	  }
 	return str;
 }
+
+uint64_t mix(uint64_t h)
+{	// splitmix64 finalizer, for hashing file contents
+	h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9;
+	h = (h ^ (h >> 27)) * 0x94d049bb133111eb;
+	return h ^ (h >> 31);
+}
+
+uint64_t hash_bytes(const char* c, size_t n, uint64_t h)
+{	// FNV-1a, seeded with h
+	h ^= 0xcbf29ce484222325;
+	for (const char* end = c+n; c < end; c++) h = (h ^ (unsigned char)*c) * 0x100000001b3;
+	return mix(h);
+}
@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <string>
 
 bool sort_1st_csv_field(const std::string&, const std::string&);
@@ -9,3 +10,5 @@ int strdcmp(const char*, const char*, const char);
 const char* strdstr(const char*, const char*, const char);
 char* format_clinched_mi(char*, double, double);
 std::string double_quotes(std::string);
+uint64_t mix(uint64_t);
+uint64_t hash_bytes(const char*, size_t, uint64_t);
@@ -14,6 +14,7 @@ This module defines classes to represent the contents of a
 */
 
 #include "classes/Args/Args.h"
+#include "classes/ConnectedRoute/ConnectedRoute.h"
 #include "classes/DBFieldLength/DBFieldLength.h"
 #include "classes/Datacheck/Datacheck.h"
 #include "classes/ElapsedTime/ElapsedTime.h"
@@ -35,6 +36,7 @@ This module defines classes to represent the contents of a
 #include "functions/route_and_label_logs.h"
 #include "functions/tmstring.h"
 #include "functions/sql_file.h"
+#include <algorithm>
 #ifdef threading_enabled
 #include <thread>
 #include "threads/threads.h"
@@ -65,13 +67,15 @@ int main(int argc, char *argv[])
 	time_t timestamp = time(0);
 	cout << "Start: " << ctime(&timestamp);
 
-	// Get list of travelers in the system
-	cout << et.et() << "Making list of travelers." << endl;
-	TravelerList::get_ids(el);
+	if (!Args::quickcheck)
+	{	// Get list of travelers in the system
+		cout << et.et() << "Making list of travelers." << endl;
+		TravelerList::get_ids(el);
 
-	// read the listfileinfo.csv file
-	cout << et.et() << "Reading listfileinfo.csv." << endl;
-	TravelerList::read_listinfo(el);
+		// read the listfileinfo.csv file
+		cout << et.et() << "Reading listfileinfo.csv." << endl;
+		TravelerList::read_listinfo(el);
+	}
 
 	cout << et.et() << "Reading region, country, and continent descriptions." << endl;
 	Region::read_csvs(el);
@@ -92,8 +96,13 @@ int main(int argc, char *argv[])
 	// quadtree of all Waypoints in existence to find them efficiently
 	WaypointQuadtree all_waypoints(-90,-180,90,180);
 
-	cout << et.et() << "Reading waypoints for all routes." << endl;
-	#include "tasks/threaded/ReadWpt.cpp"
+	if (Args::scope.size())
+	{	// read only what a scoped datacheck needs
+		#include "tasks/datacheck_scope.cpp"
+	} else
+	{	cout << et.et() << "Reading waypoints for all routes." << endl;
+		#include "tasks/threaded/ReadWpt.cpp"
+	}
 
 	//cout << et.et() << "Writing WaypointQuadtree.tmg." << endl;
 	//all_waypoints.write_qt_tmg(Args::logfilepath+"/WaypointQuadtree.tmg");
@@ -138,48 +147,52 @@ int main(int argc, char *argv[])
 
 	#include "tasks/read_updates.cpp"
 
-	cout << et.et() << "Processing traveler list files:" << endl;
-	#include "tasks/threaded/ReadList.cpp"
-	cout << endl << et.et() << "Processed " << TravelerList::allusers.size << " traveler list files." << endl;
-
-	cout << et.et() << "Clearing route & label hash tables." << endl;
-	Route::root_hash.clear();
-	Route::pri_list_hash.clear();
-	Route::alt_list_hash.clear();
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	  for (Route& r : h.routes)
-	  {	r.pri_label_hash.clear();
-		r.alt_label_hash.clear();
-		r.duplicate_labels.clear();
-	  }
+	if (Args::quickcheck)
+		cout << et.et() << "SKIPPING traveler list files, logs & stats." << endl;
+	else {
+		cout << et.et() << "Processing traveler list files:" << endl;
+		#include "tasks/threaded/ReadList.cpp"
+		cout << endl << et.et() << "Processed " << TravelerList::allusers.size << " traveler list files." << endl;
+
+		cout << et.et() << "Clearing route & label hash tables." << endl;
+		Route::root_hash.clear();
+		Route::pri_list_hash.clear();
+		Route::alt_list_hash.clear();
+		for (HighwaySystem& h : HighwaySystem::syslist)
+		  for (Route& r : h.routes)
+		  {	r.pri_label_hash.clear();
+			r.alt_label_hash.clear();
+			r.duplicate_labels.clear();
+		  }
 
-	cout << et.et() << "Writing route and label logs." << endl;
-	route_and_label_logs(&timestamp);
+		cout << et.et() << "Writing route and label logs." << endl;
+		route_and_label_logs(&timestamp);
 
-	cout << et.et() << "Augmenting travelers for detected concurrent segments." << flush;
-	#include "tasks/threaded/ConcAug.cpp"
+		cout << et.et() << "Augmenting travelers for detected concurrent segments." << flush;
+		#include "tasks/threaded/ConcAug.cpp"
 
-	/*ofstream sanetravfile(Args::logfilepath+"/concurrent_travelers_sanity_check.log");
-	for (HighwaySystem& h : HighwaySystem::syslist)
-	    for (Route& r : h.routes)
-		for (HighwaySegment& s : r.segments)
-		    sanetravfile << s.concurrent_travelers_sanity_check();
-	sanetravfile.close(); //*/
+		/*ofstream sanetravfile(Args::logfilepath+"/concurrent_travelers_sanity_check.log");
+		for (HighwaySystem& h : HighwaySystem::syslist)
+		    for (Route& r : h.routes)
+			for (HighwaySegment& s : r.segments)
+			    sanetravfile << s.concurrent_travelers_sanity_check();
+		sanetravfile.close(); //*/
 
-	// compute lots of regional stats:
-	// overall, active+preview, active only,
-	// and per-system which falls into just one of these categories
-	cout << et.et() << "Computing stats." << flush;
-	#include "tasks/threaded/CompStats.cpp"
+		// compute lots of regional stats:
+		// overall, active+preview, active only,
+		// and per-system which falls into just one of these categories
+		cout << et.et() << "Computing stats." << flush;
+		#include "tasks/threaded/CompStats.cpp"
 
-	cout << et.et() << "Writing routedatastats.log." << endl;
-	rdstats(active_only_miles, active_preview_miles, &timestamp);
+		cout << et.et() << "Writing routedatastats.log." << endl;
+		rdstats(active_only_miles, active_preview_miles, &timestamp);
 
-	cout << et.et() << "Creating per-traveler stats logs and augmenting data structure." << flush;
-	#include "tasks/threaded/UserLog.cpp"
+		cout << et.et() << "Creating per-traveler stats logs and augmenting data structure." << flush;
+		#include "tasks/threaded/UserLog.cpp"
 
-	cout << et.et() << "Writing stats csv files." << endl;
-	#include "tasks/threaded/StatsCsv.cpp"
+		cout << et.et() << "Writing stats csv files." << endl;
+		#include "tasks/threaded/StatsCsv.cpp"
+	     }
 
 	cout << et.et() << "Reading datacheckfps.csv." << endl;
 	Datacheck::read_fps(el);
@@ -205,6 +218,8 @@ int main(int argc, char *argv[])
 	thread sqlthread;
 	if   (!Args::errorcheck)
 	{	std::cout << et.et() << "Start writing database file " << Args::databasename << ".sql.\n" << std::flush;
+		// graph generation runs alongside with Args::numthreads threads of its own
+		sql_threads = Args::skipgraphs ? Args::numthreads : 1;
 		sqlthread=thread(sqlfile1, &et, &updates, &systemupdates, &term_mtx);
 	}
       #endif
@@ -218,6 +233,7 @@ int main(int argc, char *argv[])
 		cout << et.et() << "SKIPPING database file." << endl;
 	else {
 	      #ifdef threading_enabled
+		sql_threads = Args::numthreads;
 		sqlthread.join();
 		std::cout << et.et() << "Resume writing database file " << Args::databasename << ".sql.\n" << std::flush;
 	      #else
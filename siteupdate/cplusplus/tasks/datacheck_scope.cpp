@@ -0,0 +1,31 @@
+// Routes in the regions or systems given are checked. Their .wpt files are read,
+// along with the rest of their connected routes; then those of any other route with
+// a point colocated with or near one already read, and the rest of its connected route,
+// for the checks that look at nearby points & concurrencies. All others go unread.
+for (string& s : Args::scope)
+  if (!Region::code_hash.count(s)
+   && std::none_of(HighwaySystem::syslist.begin(), HighwaySystem::syslist.end(),
+		   [&](HighwaySystem& h){return h.systemname == s;}))
+	el.add_error("Datacheck scope " + s + " is neither a region nor a highway system");
+unordered_set<string> scope(Args::scope.begin(), Args::scope.end());
+for (HighwaySystem& h : HighwaySystem::syslist)
+  for (Route& r : h.routes)
+    if (!scope.count(r.rg_str) && !scope.count(h.systemname))
+	r.bools |= 12; // outside datacheck scope, .wpt not to be read
+auto whole_con_routes = []()
+{	for (HighwaySystem& h : HighwaySystem::syslist)
+	  for (ConnectedRoute& cr : h.con_routes)
+	    if (std::any_of(cr.roots.begin(), cr.roots.end(), [](Route* r){return !(r->bools & 8);}))
+	      for (Route* r : cr.roots) r->bools &= ~8;
+};
+whole_con_routes();
+
+cout << et.et() << "Reading waypoints for routes in datacheck scope." << endl;
+#include "threaded/ReadWpt.cpp"
+
+cout << et.et() << "Finding routes near them." << endl;
+#include "threaded/ScanWpt.cpp"
+whole_con_routes();
+
+cout << et.et() << "Reading waypoints for routes near them." << endl;
+#include "threaded/ReadWpt.cpp"
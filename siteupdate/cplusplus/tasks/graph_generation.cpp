@@ -3,14 +3,15 @@ HighwayGraph graph_data(all_waypoints, et);
 
 cout << et.et() << "Writing graph waypoint simplification log." << endl;
 ofstream wslogfile(Args::logfilepath + "/waypointsimplification.log");
-for (string& line : graph_data.waypoint_naming_log)
-	wslogfile << line << '\n';
+graph_data.write_naming_log(wslogfile);
 wslogfile.close();
-graph_data.waypoint_naming_log.clear();
 
 // start generating graphs and making entries for graph DB table
 {	// Let's keep these braces here, for easily commenting out subgraph generation when developing waypoint simplification routines
-	GraphListEntry::num = 3;
+	GraphListEntry::schedule();
+	GraphListEntry::num = 0;
+	GraphListEntry::reported = 3;
+	graph_data.read_manifest();
 
 	cout << et.et() << "Writing master TM graph files." << endl;
 	// print summary info
@@ -20,18 +21,19 @@ graph_data.waypoint_naming_log.clear();
 
 	// write graph vector entries to disk
       #ifdef threading_enabled
-	thr[0] = thread(MasterTmgThread, &graph_data, &list_mtx, &term_mtx, &all_waypoints, &et);
+	thr[0] = thread(MasterTmgThread, &graph_data, &list_mtx, &term_mtx, &et);
 	// start at t=1, because MasterTmgThread will spawn another SubgraphThread when finished
 	for (unsigned int t = 1; t < thr.size(); t++)
-	  thr[t] = thread(SubgraphThread, t, &list_mtx, &term_mtx, &graph_data, &all_waypoints, &et);
+	  thr[t] = thread(SubgraphThread, t, &list_mtx, &term_mtx, &graph_data, &et);
 	THREADLOOP thr[t].join();
       #else
 	for (	graph_data.write_master_graphs_tmg();
-		GraphListEntry::num < GraphListEntry::entries.size();
-		GraphListEntry::num += 3
-	    )	graph_data.write_subgraphs_tmg(GraphListEntry::num, 0, &all_waypoints, &et, &term_mtx);
+		GraphListEntry::num < GraphListEntry::order.size();
+		GraphListEntry::num++
+	    )	graph_data.write_subgraphs_tmg(GraphListEntry::order[GraphListEntry::num], 0, &et, &term_mtx);
       #endif
 	cout << '!' << endl;
+	graph_data.write_manifest();
 } //*/
 
 cout << et.et() << "Clearing HighwayGraph contents from memory." << endl;
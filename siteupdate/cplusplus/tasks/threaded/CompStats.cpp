@@ -5,4 +5,9 @@
       #else
 	for (Region& rg : Region::allregions) rg.compute_stats();
       #endif
+	// each system's regions in one canonical order, for rdstats, userlog & stats_csv
+	for (HighwaySystem& h : HighwaySystem::syslist)
+	{	for (auto& rm : h.mileage_by_region) h.regions.push_back(rm.first);
+		std::sort(h.regions.begin(), h.regions.end());
+	}
 	cout << '!' << endl;
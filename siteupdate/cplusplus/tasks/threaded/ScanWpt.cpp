@@ -0,0 +1,9 @@
+      #ifdef threading_enabled
+	HighwaySystem::it = HighwaySystem::syslist.begin();
+	THREADLOOP thr[t] = thread(ScanWptThread, t, &list_mtx, &all_waypoints);
+	THREADLOOP thr[t].join();
+      #else
+	for (HighwaySystem& h : HighwaySystem::syslist)
+	  for (Route& r : h.routes)
+	    r.scan_wpt(&all_waypoints);
+      #endif
@@ -1,3 +1,4 @@
+	HighwaySystem::list_travelers();
       #ifdef threading_enabled
 	HighwaySystem::it = HighwaySystem::syslist.begin();
 	if (Args::numthreads == 1 || Args::stcsvfiles)
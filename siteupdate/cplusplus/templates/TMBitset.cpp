@@ -95,6 +95,10 @@ template <class item, class unit> class TMBitset
 
 	bool operator [] (const size_t index) const {return data[index/ubits] & (unit)1 << index%ubits;}
 
+	// Whole units sans end() bit, for encoding a unit at a time
+	size_t num_units() const {return units;}
+	unit get_unit(size_t const u) const {return u == units-1 ? data[u] ^ (unit)1 << len%ubits : data[u];}
+
 	// The != operator assumes both objects have the same start & length, and shall only be used in this context.
 	bool operator != (const TMBitset<item,unit>& other) const {return memcmp(data, other.data, units*sizeof(unit));}
 
@@ -0,0 +1,13 @@
+void ScanWptThread(unsigned int id, std::mutex* mtx, WaypointQuadtree* all_waypoints)
+{	//printf("Starting ScanWptThread %02i\n", id); fflush(stdout);
+	while (HighwaySystem::it != HighwaySystem::syslist.end())
+	{	mtx->lock();
+		if (HighwaySystem::it == HighwaySystem::syslist.end())
+			return mtx->unlock();
+		HighwaySystem* h = HighwaySystem::it++;
+		mtx->unlock();
+
+		for (Route& r : h->routes)
+			r.scan_wpt(all_waypoints);
+	}
+}
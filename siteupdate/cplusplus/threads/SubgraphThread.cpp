@@ -1,19 +1,18 @@
 void SubgraphThread
 (	unsigned int id, std::mutex* l, std::mutex* t,
-	HighwayGraph* graph_data, WaypointQuadtree* qt, ElapsedTime* et
+	HighwayGraph* graph_data, ElapsedTime* et
 )
 {	//std::cout << "Starting SubgraphThread " << id << std::endl;
-	while (GraphListEntry::num < GraphListEntry::entries.size())
+	while (GraphListEntry::num < GraphListEntry::order.size())
 	{	l->lock();
-		if (GraphListEntry::num >= GraphListEntry::entries.size())
+		if (GraphListEntry::num >= GraphListEntry::order.size())
 		{	l->unlock();
 			return;
 		}
-		//std::cout << "Thread " << id << " with graph_vector.size()=" << graph_vector->size() << " & index=" << GraphListEntry::num << std::endl;
-		//std::cout << "Thread " << id << " assigned " << GraphListEntry::entries.at(GraphListEntry::num).tag() << std::endl;
-		size_t i = GraphListEntry::num;
-		GraphListEntry::num += 3;
+		//std::cout << "Thread " << id << " with order.size()=" << GraphListEntry::order.size() << " & index=" << GraphListEntry::num << std::endl;
+		//std::cout << "Thread " << id << " assigned " << GraphListEntry::entries.at(GraphListEntry::order[GraphListEntry::num]).tag() << std::endl;
+		size_t i = GraphListEntry::order[GraphListEntry::num++];
 		l->unlock();
-		graph_data->write_subgraphs_tmg(i, id, qt, et, t);
+		graph_data->write_subgraphs_tmg(i, id, et, t);
 	}
 }
@@ -18,6 +18,7 @@
 #include "NmpSearchThread.cpp"
 #include "ReadListThread.cpp"
 #include "ReadWptThread.cpp"
+#include "ScanWptThread.cpp"
 #include "RteIntThread.cpp"
 #include "StatsCsvThread.cpp"
 #include "SubgraphThread.cpp"
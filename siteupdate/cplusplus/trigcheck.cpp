@@ -0,0 +1,125 @@
+// Tab Width = 8
+
+/* Check Waypoint::Trig, which precomputes trig once per route for
+segment lengths & angles, against the per-call formulas it replaced,
+over sample coordinates including the poles, the antimeridian and
+coincident points. Results must be bit-identical; any mismatch is
+reported and the program exits nonzero.
+
+Usage: make trigcheck && ./trigcheck
+*/
+
+#include "classes/ErrorList/ErrorList.h"
+#include "classes/Waypoint/Waypoint.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const double pi = 3.141592653589793238;
+
+static double distance_to(double lat0, double lng0, double lat1, double lng1)
+{	/* the original Waypoint::distance_to */
+	double rlat1 = lat0 * (pi/180);
+	double rlng1 = lng0 * (pi/180);
+	double rlat2 = lat1 * (pi/180);
+	double rlng2 = lng1 * (pi/180);
+
+	double ans = asin(sqrt(pow(sin((rlat2-rlat1)/2),2) + cos(rlat1) * cos(rlat2) * pow(sin((rlng2-rlng1)/2),2))) * 7926.2; // EARTH_DIAMETER
+	return ans * 1.02112;
+}
+
+static double angle(double lat0, double lng0, double lat1, double lng1, double lat2, double lng2)
+{	/* the original Waypoint::angle */
+	double x0 = cos(lng0*(pi/180))*cos(lat0*(pi/180));
+	double x1 = cos(lng1*(pi/180))*cos(lat1*(pi/180));
+	double x2 = cos(lng2*(pi/180))*cos(lat2*(pi/180));
+
+	double y0 = sin(lng0*(pi/180))*cos(lat0*(pi/180));
+	double y1 = sin(lng1*(pi/180))*cos(lat1*(pi/180));
+	double y2 = sin(lng2*(pi/180))*cos(lat2*(pi/180));
+
+	double z0 = sin(lat0*(pi/180));
+	double z1 = sin(lat1*(pi/180));
+	double z2 = sin(lat2*(pi/180));
+
+	return acos(((x2 - x1)*(x1 - x0) + (y2 - y1)*(y1 - y0) + (z2 - z1)*(z1 - z0))
+		  / sqrt(((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1) + (z2 - z1) * (z2 - z1))
+		  * ((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0) + (z1 - z0) * (z1 - z0))))
+		  * 180 / pi;
+}
+
+static bool mismatch(double a, double b)
+{	// bitwise, so NaNs from coincident points compare too
+	return memcmp(&a, &b, sizeof(double));
+}
+
+static size_t checked = 0, failed = 0;
+
+static void check(const char* name, const std::vector<std::pair<double,double>>& coords)
+{	// build the route's waypoints the way read_wpt does, from .wpt lines
+	ErrorList el;
+	std::vector<Waypoint> points;
+	points.reserve(coords.size());
+	char line[256];
+	for (size_t i = 0; i < coords.size(); i++)
+	{	snprintf(line, sizeof(line), "P%zu http://www.openstreetmap.org/?lat=%.6f&lon=%.6f", i, coords[i].first, coords[i].second);
+		points.emplace_back(line, nullptr, el, line);
+	}
+
+	Waypoint::Trig trig(points.data(), points.size());
+	for (size_t i = 1; i < points.size(); i++)
+	{	Waypoint *p = &points[i-1], *w = &points[i];
+		double expected = distance_to(p->lat, p->lng, w->lat, w->lng);
+		double actual = trig.distance(i);
+		checked++;
+		if (mismatch(expected, actual))
+		{	failed++;
+			printf("%s: distance %s (%.6f,%.6f) -> %s (%.6f,%.6f): expected %.17g, got %.17g\n",
+				name, p->label.data(), p->lat, p->lng, w->label.data(), w->lat, w->lng, expected, actual);
+		}
+	}
+	for (size_t i = 1; i+1 < points.size(); i++)
+	{	Waypoint *p = &points[i-1], *w = &points[i], *s = &points[i+1];
+		double expected = angle(p->lat, p->lng, w->lat, w->lng, s->lat, s->lng);
+		double actual = trig.angle(i);
+		checked++;
+		if (mismatch(expected, actual))
+		{	failed++;
+			printf("%s: angle at %s (%.6f,%.6f): expected %.17g, got %.17g\n",
+				name, w->label.data(), w->lat, w->lng, expected, actual);
+		}
+	}
+}
+
+int main()
+{	check("poles", {{90,0}, {89.999999,45}, {90,180}, {0,0}, {-90,0}, {-89.999999,-135}, {-90,180}, {-90,0}});
+	check("antimeridian", {{10,179.999999}, {10,-179.999999}, {10.000001,180}, {10,-180},
+			       {-20,179.5}, {-20,-179.5}, {65.5,-168.9}, {65.6,169.2}, {0,180}, {0,-180}});
+	check("coincident", {{40.7,-74}, {40.7,-74}, {40.7,-74}, {40.700001,-74}, {40.7,-74}, {40.7,-74.000001}, {40.7,-74}});
+	check("ordinary", {{42.740467,-73.675926}, {42.745232,-73.682148}, {42.751339,-73.688373},
+			   {51.501476,-0.140634}, {-33.856784,151.215297}, {35.689487,139.691711}});
+
+	// pseudo-random walks all over the globe, with short steps like real routes
+	unsigned long long seed = 1;
+	auto next = [&](double lo, double hi)
+	{	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		return lo + (hi-lo) * (seed >> 11) / 9007199254740992.0;
+	};
+	for (int r = 0; r < 1000; r++)
+	{	std::vector<std::pair<double,double>> walk(1, {next(-90,90), next(-180,180)});
+		for (int i = 1; i < 50; i++)
+		{	double lat = walk.back().first + next(-0.05,0.05);
+			double lng = walk.back().second + next(-0.05,0.05);
+			if (lat > 90)	lat = 90;
+			if (lat < -90)	lat = -90;
+			if (lng > 180)	lng -= 360;
+			if (lng < -180)	lng += 360;
+			walk.emplace_back(lat, lng);
+		}
+		check("random", walk);
+	}
+
+	printf("%zu distances & angles checked, %zu not bit-identical\n", checked, failed);
+	return failed != 0;
+}